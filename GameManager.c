@@ -6,6 +6,8 @@
 #include "io/Parser.h"
 #include "io/validators.h"
 #include "io/Printer.h"
+#include "components/Geometry.h"
+#include "logic/backend.h"
 
 #define MAX_COMMAND_LEN 256
 #define INPUT_LEN (MAX_COMMAND_LEN + 2)
@@ -19,6 +21,8 @@ void handle_eof(Game *game, Command *command) {
         announce_exit();
         destroy_command(command);
         destroy_game(game);
+        release_geometries();
+        release_backends();
         exit(0);
     }
 }
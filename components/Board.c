@@ -1,109 +1,113 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "Board.h"
+#include "SplitMix64.h"
 #include "../MemoryError.h"
-#include "List.h"
 
-struct BoardCell {
-    int val;
-    int row;
-    int column;
-    bool fixed;
-    bool erroneous;
-    List *neighbors;
-    List *conflicting;
-};
-
-
-/* Creates a new board cell. */
-BoardCell* create_cell(int row, int column) {
-    BoardCell *cell = malloc(sizeof(BoardCell));
-    validate_memory_allocation("create_cell", cell);
-
-    cell->val = CLEAR;
-    cell->row = row;
-    cell->column = column;
-    cell->fixed = false;
-    cell->erroneous = false;
-    cell->neighbors = NULL;
-    cell->conflicting = create_list();
-
-    return cell;
-}
+#define CELL_INDEX(board, row, column) ((row) * (board)->dim + (column))
+
+/* The hash keys (see get_board_hash) */
+#define KEYS_PER_CELL (MAX_DIM + 1)
+#define CELL_KEY_INDEX(cell, value) ((uint64_t) (cell) * KEYS_PER_CELL + (uint64_t) (value))
+#define FIXED_KEY_INDEX(cell) CELL_KEY_INDEX(cell, CLEAR)
+#define SHAPE_KEY_INDEX(rows, columns) CELL_KEY_INDEX(MAX_DIM * MAX_DIM + (rows), columns)
 
-/* Destroys the given board cell (frees all related memory). */
-void destroy_cell(BoardCell *cell) {
-    if (cell->neighbors != NULL) {
-        clear_list(cell->neighbors);
-        destroy_list(cell->neighbors);
-    }
 
-    clear_list(cell->conflicting);
-    destroy_list(cell->conflicting);
-    free(cell);
+/* Gets the hash key with the given index: the (index + 1)-th output of
+ * SplitMix64 seeded with 0, which is computed directly from the index. */
+uint64_t get_hash_key(uint64_t index) {
+    return mix_splitmix_bits((index + 1) * SPLITMIX_GAMMA);
 }
 
-/* Creates a row of cells, at the given index, and of the given length. */
-BoardCell** create_row(int length, int index) {
-    int i;
-    BoardCell **row = malloc(length * sizeof(BoardCell*));
-    validate_memory_allocation("create_row", row);
+/* Returns the size of the single data allocation of a board of the given
+ * dimension (see layout_board_data). */
+size_t get_board_data_size(int dim) {
+    int num_of_cells = dim * dim;
 
-    for (i=0; i < length; i++) {
-        row[i] = create_cell(index, i);
-    }
+    return 6 * dim * sizeof(ValueSet)           /* unit value sets (all & fixed) */
+           + num_of_cells * sizeof(int)         /* values */
+           + 3 * dim * dim * sizeof(int)        /* unit value counts */
+           + num_of_cells * sizeof(bool);       /* fixed flags */
+}
 
-    return row;
+/* Sets the array pointers of the board to their places in the board's single
+ * data allocation. The arrays are laid out by decreasing alignment (value
+ * sets, then ints, then bools), so no padding is needed between them. */
+void layout_board_data(Board *board) {
+    int dim = board->dim;
+    char *data = board->_data;
+
+    board->_row_values = (ValueSet*) data;
+    board->_column_values = board->_row_values + dim;
+    board->_block_values = board->_column_values + dim;
+    board->_fixed_row_values = board->_block_values + dim;
+    board->_fixed_column_values = board->_fixed_row_values + dim;
+    board->_fixed_block_values = board->_fixed_column_values + dim;
+    data = (char*) (board->_fixed_block_values + dim);
+
+    board->_values = (int*) data;
+    board->_row_counts = board->_values + dim * dim;
+    board->_column_counts = board->_row_counts + dim * dim;
+    board->_block_counts = board->_column_counts + dim * dim;
+    data = (char*) (board->_block_counts + dim * dim);
+
+    board->_fixed = (bool*) data;
 }
 
-/* Destroys a row of cells (frees all related memory). */
-void destroy_row(BoardCell **row, int length) {
-    int i;
-    for (i=0; i < length; i++) {
-        destroy_cell(row[i]);
-    }
+/* Allocates a new board of the given dimensions, without initializing the
+ * state of its cells. */
+Board* allocate_board(int rows_in_block, int columns_in_block) {
+    Board *board = malloc(sizeof(Board));
+    validate_memory_allocation("allocate_board", board);
+
+    board->num_of_rows_in_block = rows_in_block;
+    board->num_of_columns_in_block = columns_in_block;
+    board->dim = rows_in_block * columns_in_block;
+    board->_geometry = get_geometry(rows_in_block, columns_in_block);
 
-    free(row);
+    board->_data = malloc(get_board_data_size(board->dim));
+    validate_memory_allocation("allocate_board", board->_data);
+    layout_board_data(board);
+
+    /* the trail is only allocated once a level is pushed */
+    board->_trail = NULL;
+    board->_trail_size = 0;
+    board->_trail_capacity = 0;
+    board->_levels = NULL;
+    board->_num_of_levels = 0;
+    board->_levels_capacity = 0;
+
+    return board;
 }
 
 Board* create_board(int rows_in_block, int columns_in_block){
     int i, dim;
-    BoardCell ***_cells_arr;
+    Board *board = allocate_board(rows_in_block, columns_in_block);
 
-    Board *board = malloc(sizeof(Board));
-    validate_memory_allocation("create_board", board);
-
-    dim = rows_in_block * columns_in_block;
-    board->num_of_rows_in_block = rows_in_block;
-    board->num_of_columns_in_block = columns_in_block;
-    board->dim = dim;
+    dim = board->dim;
     board->solved = false;
     board->empty_count = dim * dim;
     board->errors_count = 0;
+    board->_hash = get_hash_key(SHAPE_KEY_INDEX(rows_in_block, columns_in_block));
 
-    _cells_arr = malloc(dim * sizeof(BoardCell**));
-    validate_memory_allocation("create_board", board);
-
-    for (i=0; i < dim; i++) {
-        _cells_arr[i] = create_row(dim, i);
+    /* all zeros is an empty board: CLEAR values, no fixed cells */
+    memset(board->_data, 0, get_board_data_size(dim));
+    for (i = 0; i < 6 * dim; i++) {
+        clear_value_set(&board->_row_values[i]);
     }
 
-    board->_cells_arr = _cells_arr;
     return board;
 }
 
 void destroy_board(Board *board){
-    int i;
-
     if (board == NULL) {
         return;
     }
-    
-    for (i=0; i < board->dim; i++) {
-        destroy_row(board->_cells_arr[i], board->dim);
-    }
 
-    free(board->_cells_arr);
+    free(board->_trail);
+    free(board->_levels);
+    free(board->_data);
     free(board);
 }
 
@@ -111,15 +115,15 @@ void destroy_board(Board *board){
 /* Query functions */
 
 bool is_cell_fixed(const Board *board, int row, int column) {
-    return board->_cells_arr[row][column]->fixed;
+    return board->_fixed[CELL_INDEX(board, row, column)];
 }
 
 bool is_cell_empty(const Board *board, int row, int column) {
-    return board->_cells_arr[row][column]->val == CLEAR;
+    return board->_values[CELL_INDEX(board, row, column)] == CLEAR;
 }
 
 int get_cell_value(const Board *board, int row, int column) {
-    return board->_cells_arr[row][column]->val;
+    return board->_values[CELL_INDEX(board, row, column)];
 }
 
 bool is_board_erroneous(const Board *board){
@@ -127,166 +131,230 @@ bool is_board_erroneous(const Board *board){
 }
 
 bool is_cell_erroneous(const Board *board, int row, int column){
-    return board->_cells_arr[row][column]->erroneous;
+    int cell = CELL_INDEX(board, row, column), value = board->_values[cell];
+
+    /* fixed cells are never erroneous */
+    if (value == CLEAR || board->_fixed[cell]) {
+        return false;
+    }
+    return !is_legal_value(board, row, column, value);
 }
 
 
-/* updates the integers r_start, r_end, c_start, c_end to the row and column indices of
- * the block of cell (row, column) in the board. */
-void get_block_indices(const Board *board, int row, int column, int *r_start, int *r_end, int *c_start, int *c_end) {
-    *r_start = row - (row % board->num_of_rows_in_block);
-    *r_end = *r_start + board->num_of_rows_in_block;
-    *c_start = column - (column % board->num_of_columns_in_block);
-    *c_end = *c_start + board->num_of_columns_in_block;
+int get_block_index(const Board *board, int row, int column) {
+    return board->_geometry->blocks[CELL_INDEX(board, row, column)];
 }
 
-/* Generates a new list of neighboring cells of the cell at the given coordinates. */
-List* generate_neighbors_list(const Board *board, int row, int column) {
-    int i, r_start, r_end, j, c_start, c_end;
-    List *neighbors = create_list();
 
-    /* row & column neighbors */
-    for (i=0; i < board->dim; i++) {
-        if (i != column) {
-            add(neighbors, board->_cells_arr[row][i]);
-        }
-        if (i != row) {
-            add(neighbors, board->_cells_arr[i][column]);
-        }
-    }
-
-    /* block neighbors */
-    get_block_indices(board, row, column, &r_start, &r_end, &c_start, &c_end);
-    for (i = r_start; i < r_end; i++) {
-        for (j = c_start; j < c_end; j++) {
-            if (i != row && j != column) {
-                add(neighbors, board->_cells_arr[i][j]);
-            }
-        }
-    }
-    return neighbors;
+uint64_t get_board_hash(const Board *board) {
+    return board->_hash;
 }
 
-/* Returns the neighbors list (creates one if wasn't already created).
- * Also resets the lists head. */
-List* get_neighbors(Board *board, int row, int column) {
-    if (board->_cells_arr[row][column]->neighbors == NULL) {
-        board->_cells_arr[row][column]->neighbors = generate_neighbors_list(board, row, column);
-    }
 
-    reset_head(board->_cells_arr[row][column]->neighbors);
-    return board->_cells_arr[row][column]->neighbors;
+const int* get_unit_cells(const Board *board, UnitType type, int unit) {
+    return board->_geometry->units + (type * board->dim + unit) * board->dim;
 }
 
-/* Returns the list of conflicting cells. */
-List* get_conflicting(Board *board, int row, int column) {
-    reset_head(board->_cells_arr[row][column]->conflicting);
-    return board->_cells_arr[row][column]->conflicting;
+const ValueSet* get_unit_values(const Board *board, UnitType type, int unit) {
+    if (type == row_unit) {
+        return &board->_row_values[unit];
+    }
+    if (type == column_unit) {
+        return &board->_column_values[unit];
+    }
+    return &board->_block_values[unit];
 }
 
 
 /* Board manipulation functions */
 
-/* Adds a conflict between two cells (adds the second to the first's conflicting
- * list, and updates the board's error_count and erroneous status. */
-void add_conflict(Board *board, BoardCell *cell, BoardCell *conflicting_cell) {
-    /* fixed cells are never erroneous */
-    if (cell->fixed) {
-        return;
+/* Updates the unit value tables for a value entering (delta = 1) or leaving
+ * (delta = -1) the cell at the given coordinates, and the board's errors_count
+ * for each unit where the value is repeated. */
+void update_unit_tables(Board *board, int row, int column, int value, int delta) {
+    int dim = board->dim, block = get_block_index(board, row, column);
+    int *counts[3];
+    ValueSet *values[3];
+    int i;
+
+    counts[0] = &board->_row_counts[row * dim + value - 1];
+    counts[1] = &board->_column_counts[column * dim + value - 1];
+    counts[2] = &board->_block_counts[block * dim + value - 1];
+    values[0] = &board->_row_values[row];
+    values[1] = &board->_column_values[column];
+    values[2] = &board->_block_values[block];
+
+    for (i = 0; i < 3; i++) {
+        if (delta > 0) {
+            if (*counts[i] > 0) { /* the value is now repeated in the unit */
+                board->errors_count++;
+            }
+            add_value(values[i], value);
+        } else {
+            if (*counts[i] > 1) { /* one less repetition of the value in the unit */
+                board->errors_count--;
+            } else {
+                remove_value(values[i], value);
+            }
+        }
+        *counts[i] += delta;
     }
+}
 
-    if (is_empty(cell->conflicting)) {
-        cell->erroneous = true;
-        board->errors_count++;
+/* Adds or removes (based on add) the value of the fixed cell at the given
+ * coordinates to/from the fixed values of its units. */
+void update_fixed_values(Board *board, int row, int column, int value, bool add) {
+    int block = get_block_index(board, row, column);
+
+    if (add) {
+        add_value(&board->_fixed_row_values[row], value);
+        add_value(&board->_fixed_column_values[column], value);
+        add_value(&board->_fixed_block_values[block], value);
+    } else {
+        remove_value(&board->_fixed_row_values[row], value);
+        remove_value(&board->_fixed_column_values[column], value);
+        remove_value(&board->_fixed_block_values[block], value);
     }
-    add(cell->conflicting, conflicting_cell);
 }
 
-/* removes a conflict. updates the cell's conflicting list, and the board's
- * error_count and erroneous status accordingly. */
-void remove_conflict(Board *board, BoardCell *cell, BoardCell *conflicting_cell) {
-    bool had_conflicts = !is_empty(cell->conflicting);
+/* Records a change of the given cell on the trail (grows the trail in the
+ * rare case it's full). */
+void record_change(Board *board, int cell, int prev_value) {
+    if (board->_trail_size == board->_trail_capacity) {
+        board->_trail_capacity *= 2;
+        board->_trail = realloc(board->_trail, 2 * board->_trail_capacity * sizeof(int));
+        validate_memory_allocation("record_change", board->_trail);
+    }
+
+    board->_trail[2 * board->_trail_size] = cell;
+    board->_trail[2 * board->_trail_size + 1] = prev_value;
+    board->_trail_size++;
+}
 
-    delete(cell->conflicting, conflicting_cell);
+/* Sets the value of the given cell, and updates the unit tables and counters. */
+void apply_cell_value(Board *board, int cell, int value) {
+    int row = cell / board->dim, column = cell % board->dim, prev_value = board->_values[cell];
 
-    if (had_conflicts && is_empty(cell->conflicting)) {
-        cell->erroneous = false;
-        board->errors_count--;
+    if (prev_value != CLEAR) {
+        board->_hash ^= get_hash_key(CELL_KEY_INDEX(cell, prev_value));
+        update_unit_tables(board, row, column, prev_value, -1);
+        if (board->_fixed[cell]) {
+            update_fixed_values(board, row, column, prev_value, false);
+        }
     }
+    if (value != CLEAR) {
+        board->_hash ^= get_hash_key(CELL_KEY_INDEX(cell, value));
+        update_unit_tables(board, row, column, value, 1);
+        if (board->_fixed[cell]) {
+            update_fixed_values(board, row, column, value, true);
+        }
+    }
+
+    if (value == CLEAR) {
+        board->empty_count++;
+    } else if (prev_value == CLEAR) {
+        board->empty_count--;
+    }
+    board->_values[cell] = value;
 }
 
 void set_cell_value(Board *board, int row, int column, int value) {
-    BoardCell *neighbor;
-    List *neighbors;
+    int cell = CELL_INDEX(board, row, column);
 
     /* no action needed (value wasn't changed) */
-    if (board->_cells_arr[row][column]->val == value) {
+    if (board->_values[cell] == value) {
         return;
     }
 
-    neighbors = get_neighbors(board, row, column);
+    if (board->_num_of_levels > 0) {
+        record_change(board, cell, board->_values[cell]);
+    }
+    apply_cell_value(board, cell, value);
+}
 
-    if (!is_empty(neighbors)) {
-        do {
-            neighbor = (BoardCell*) get_current_item(neighbors);
-            if (neighbor->val == CLEAR) {
-                /* conflicts are not relevant for clear cells */
-            } else if (neighbor->val == value) {
-                add_conflict(board, board->_cells_arr[row][column], neighbor);
-                add_conflict(board, neighbor, board->_cells_arr[row][column]);
+bool fix_cell(Board *board, int row, int column) {
+    int cell = CELL_INDEX(board, row, column), value = board->_values[cell];
+    int block = get_block_index(board, row, column);
 
-            } else if (neighbor->val == board->_cells_arr[row][column]->val) {
-                remove_conflict(board, board->_cells_arr[row][column], neighbor);
-                remove_conflict(board, neighbor, board->_cells_arr[row][column]);
-            }
-        } while (next(neighbors) == 0);
+    if (board->_fixed[cell]) {
+        return true;
     }
 
-    if (value == CLEAR) {
-        board->empty_count++;
-    } else if (board->_cells_arr[row][column]->val == CLEAR) {
-        board->empty_count--;
+    if (value != CLEAR) {
+        /* validate there are no conflicting fixed neighbors */
+        if (contains_value(&board->_fixed_row_values[row], value)
+            || contains_value(&board->_fixed_column_values[column], value)
+            || contains_value(&board->_fixed_block_values[block], value)) {
+            return false;
+        }
+        update_fixed_values(board, row, column, value, true);
     }
-    board->_cells_arr[row][column]->val = value;
+
+    board->_fixed[cell] = true;
+    board->_hash ^= get_hash_key(FIXED_KEY_INDEX(cell));
+    return true;
 }
 
-bool fix_cell(Board *board, int row, int column) {
-    BoardCell *conflicting_neighbor;
-    List *conflicting = get_conflicting(board, row, column);
-
-    /* validate there are no conflicting fixed neighbors */
-    if (!is_empty(conflicting)) {
-        do {
-            conflicting_neighbor = (BoardCell*) get_current_item(conflicting);
-            if (conflicting_neighbor->fixed == true) {
-                return false;
-            }
-        } while (next(conflicting) == 0);
+void restore_board(Board *board, const Board *snapshot) {
+    memcpy(board->_data, snapshot->_data, get_board_data_size(board->dim));
+    board->_trail_size = 0;
+    board->_num_of_levels = 0;
+    board->solved = snapshot->solved;
+    board->errors_count = snapshot->errors_count;
+    board->empty_count = snapshot->empty_count;
+    board->_hash = snapshot->_hash;
+}
+
+Board* get_board_copy(const Board *board){
+    Board *copy = allocate_board(board->num_of_rows_in_block, board->num_of_columns_in_block);
+    restore_board(copy, board);
+    return copy;
+}
+
+
+/* Trail functions */
+
+void push_level(Board *board) {
+    int num_of_cells = board->dim * board->dim;
+
+    /* a search assigns each cell at most once along a path, so one entry per
+     * cell (and one level per cell) is enough for the common case */
+    if (board->_trail == NULL) {
+        board->_trail_capacity = num_of_cells;
+        board->_trail = malloc(2 * board->_trail_capacity * sizeof(int));
+        validate_memory_allocation("push_level", board->_trail);
+        board->_levels_capacity = num_of_cells + 1;
+        board->_levels = malloc(board->_levels_capacity * sizeof(int));
+        validate_memory_allocation("push_level", board->_levels);
     }
 
-    board->_cells_arr[row][column]->fixed = true;
-    return true;
+    if (board->_num_of_levels == board->_levels_capacity) {
+        board->_levels_capacity *= 2;
+        board->_levels = realloc(board->_levels, board->_levels_capacity * sizeof(int));
+        validate_memory_allocation("push_level", board->_levels);
+    }
+
+    board->_levels[board->_num_of_levels] = board->_trail_size;
+    board->_num_of_levels++;
 }
 
-Board* get_board_copy(const Board *board){
-    int i, j, val, N;
-    Board *copy = create_board(board->num_of_rows_in_block, board->num_of_columns_in_block);
-    N = board->dim;
-    for (i=0 ; i<N ; i++){
-        for (j=0 ; j<N ; j++){
-            val = get_cell_value(board, i, j);
-            set_cell_value(copy, i, j, val);
-            if (is_cell_fixed(board, i, j)){
-                fix_cell(copy, i, j);
-            }
-        }
+void pop_level(Board *board) {
+    int start;
+
+    if (board->_num_of_levels == 0) {
+        return;
     }
 
-    if (board->solved) {
-        copy->solved = true;
+    board->_num_of_levels--;
+    start = board->_levels[board->_num_of_levels];
+    while (board->_trail_size > start) {
+        board->_trail_size--;
+        apply_cell_value(board, board->_trail[2 * board->_trail_size], board->_trail[2 * board->_trail_size + 1]);
     }
+}
 
-    return copy;
+int get_level(const Board *board) {
+    return board->_num_of_levels;
 }
 
 bool fix_non_empty_board_cells(Board *board){
@@ -305,42 +373,52 @@ bool fix_non_empty_board_cells(Board *board){
 }
 
 
-void mark_neighboring_values(Board *board, bool *marks, int row, int column) {
-    int i;
-    BoardCell *neighbor;
-    List *neighbors = get_neighbors(board, row, column);
+void get_cell_candidates(const Board *board, ValueSet *candidates, int row, int column) {
+    unsigned int i;
+    int block = get_block_index(board, row, column);
+    int value = board->_values[CELL_INDEX(board, row, column)];
 
-    if (is_empty(neighbors)) {
-        return;
+    fill_value_set(candidates, board->dim);
+    for (i = 0; i < VALUE_SET_WORDS; i++) {
+        candidates->words[i] &= ~(board->_row_values[row].words[i]
+                                  | board->_column_values[column].words[i]
+                                  | board->_block_values[block].words[i]);
     }
 
-    /* Clear marks */
-    for (i=0; i < board->dim; i++) {
-        marks[i] = false;
+    /* the cell's own value is only legal if no neighbor shares it */
+    if (value != CLEAR && is_legal_value(board, row, column, value)) {
+        add_value(candidates, value);
     }
-
-    do {
-        neighbor = (BoardCell*) get_current_item(neighbors);
-        if (neighbor->val != CLEAR) {
-            marks[neighbor->val - 1] = true;
-        }
-    } while (next(neighbors) == 0);
 }
 
-int get_obvious_value(Board *board, bool *marks, int row, int column) {
-    int i, total = 0, value = 0;
-    mark_neighboring_values(board, marks, row, column);
+void get_used_values(const Board *board, ValueSet *values) {
+    int row;
+    unsigned int i;
 
-    for (i=0; i < board->dim; i++) {
-        if (marks[i]) {
-            total++;
-        } else {
-            value = i + 1;
+    /* every used value appears in some row */
+    clear_value_set(values);
+    for (row = 0; row < board->dim; row++) {
+        for (i = 0; i < VALUE_SET_WORDS; i++) {
+            values->words[i] |= board->_row_values[row].words[i];
         }
     }
+}
+
+bool is_legal_value(const Board *board, int row, int column, int value) {
+    int dim = board->dim, block = get_block_index(board, row, column);
+    int own = (board->_values[CELL_INDEX(board, row, column)] == value) ? 1 : 0;
+
+    return board->_row_counts[row * dim + value - 1] == own
+           && board->_column_counts[column * dim + value - 1] == own
+           && board->_block_counts[block * dim + value - 1] == own;
+}
+
+int get_obvious_value(const Board *board, int row, int column) {
+    ValueSet candidates;
+    get_cell_candidates(board, &candidates, row, column);
 
-    if (total == board->dim - 1) {
-        return value;
+    if (count_values(&candidates) == 1) {
+        return get_next_value(&candidates, CLEAR);
     }
     return ERROR_VALUE; /* return value ERROR_VALUE means no obvious value exists */
 }
@@ -2,7 +2,9 @@
 #define FINAL_PROJECT_BOARD_H
 
 #include <stdbool.h>
-#include "List.h"
+#include <stdint.h>
+#include "ValueSet.h"
+#include "Geometry.h"
 
 #define CLEAR (0)
 #define MIN_INDEX (1)
@@ -12,22 +14,47 @@
  *
  *  The component is used to manage the puzzle's board.
  *  It contains the board's cells, and general information about the state of
- *  the board, such as the number of empty and erroneous cells, the board's
+ *  the board, such as the number of empty cells and errors, the board's
  *  dimensions, and whether or not it is solved.
+ *  Conflicts are tracked by counting the occurrences of each value in each
+ *  row, column and block, so all the queries and updates of a single cell are
+ *  done in constant time.
+ *  The board also keeps a 64-bit Zobrist hash of its state (see
+ *  get_board_hash), updated in constant time by every change.
  */
 
-/* BoardCells are not to be used directly by external modules. See query and
- * board manipulation functions for further usage information. */
-typedef struct BoardCell BoardCell;
-
+/* The cell arrays and the unit value tables are not to be used directly by
+ * external modules. See query and board manipulation functions for further
+ * usage information.
+ * All cell arrays are indexed by row * dim + column, and are carved out of a
+ * single allocation (see _data). */
 typedef struct {
     int dim;
     int num_of_rows_in_block;
     int num_of_columns_in_block;
-    BoardCell ***_cells_arr;
+    int *_values;             /* the value of each cell (CLEAR if empty) */
+    bool *_fixed;             /* whether each cell is fixed */
+    int *_row_counts;         /* occurrences of each value per row ([row * dim + value - 1]) */
+    int *_column_counts;      /* occurrences of each value per column */
+    int *_block_counts;       /* occurrences of each value per block */
+    ValueSet *_row_values;    /* the values used in each row */
+    ValueSet *_column_values; /* the values used in each column */
+    ValueSet *_block_values;  /* the values used in each block */
+    ValueSet *_fixed_row_values;    /* the values of the fixed cells in each row */
+    ValueSet *_fixed_column_values; /* the values of the fixed cells in each column */
+    ValueSet *_fixed_block_values;  /* the values of the fixed cells in each block */
+    const Geometry *_geometry; /* the shared index tables of the board's shape */
+    void *_data;              /* the single allocation backing the arrays above */
+    int *_trail;              /* (cell, previous value) pairs of the changes made since the first level */
+    int _trail_size;          /* the number of changes in the trail */
+    int _trail_capacity;      /* the number of changes the trail can hold before it grows */
+    int *_levels;             /* the trail size at the start of each level */
+    int _num_of_levels;       /* the number of open levels (0 means changes aren't recorded) */
+    int _levels_capacity;     /* the number of levels that can be opened before the array grows */
     bool solved;
-    int errors_count;
+    int errors_count;         /* the number of repeated values in the board's units (0 iff no errors) */
     int empty_count;
+    uint64_t _hash;           /* the Zobrist hash of the board's state (see get_board_hash) */
 } Board;
 
 
@@ -95,30 +122,93 @@ bool is_board_erroneous(const Board *board);
 bool is_cell_erroneous(const Board *board, int row, int column);
 
 /**
- * Fill the marks array according to the values of the cell's neighbors (for
- * example, if there exists a neighbor with value 3, then cell 2 (value-1) will
- * be set to true. Additionally, if there's no neighbor with value 4, then cell
- * 3 will be set to false).
+ * Gets the index of the block the cell at the given coordinates belongs to.
+ * Blocks are indexed row by row, starting from the top-left block.
+ * @param board: the board to check.
+ * @param row: the index of the cell's row (zero-based).
+ * @param column: the index of the cell's column (zero-based).
+ * @return: the index of the cell's block (zero-based).
+ */
+int get_block_index(const Board *board, int row, int column);
+
+/**
+ * Gets the Zobrist hash of the board's state: its shape, the values of its
+ * cells and which cells are fixed. Equal states have equal hashes, however
+ * they were reached, and different states have different hashes with
+ * overwhelming probability.
+ * The hash is the XOR of a key per non-empty cell and value, a key per fixed
+ * cell, and a key for the board's shape. Key number i is the (i + 1)-th output
+ * of SplitMix64 seeded with 0, where i is cell * 100 + value for a cell's
+ * value, cell * 100 for a fixed cell, and 99 * 99 * 100 + rows_in_block * 100
+ * + columns_in_block for the shape (cells are indexed by row * dim + column).
+ * The keys don't depend on the process or the run, so hashes can be persisted
+ * and compared between processes.
+ * @param board: the board to get the hash of.
+ * @return: the hash of the board's state.
+ */
+uint64_t get_board_hash(const Board *board);
+
+/**
+ * Gets the cells of a row, column or block of the board.
+ * @param board: the board to get the cells of.
+ * @param type: the type of the unit (row_unit, column_unit or block_unit).
+ * @param unit: the index of the unit (zero-based, blocks are indexed as in
+ * get_block_index).
+ * @return: the indices (row * dim + column) of the unit's dim cells. Must not
+ * be modified or freed.
+ */
+const int* get_unit_cells(const Board *board, UnitType type, int unit);
+
+/**
+ * Gets the values that are used by the cells of a row, column or block of the
+ * board (kept up to date by every change).
+ * @param board: the board to get the values of.
+ * @param type: the type of the unit (row_unit, column_unit or block_unit).
+ * @param unit: the index of the unit (zero-based, as in get_unit_cells).
+ * @return: the set of the unit's values. Must not be modified or freed, and
+ * changes with the board.
+ */
+const ValueSet* get_unit_values(const Board *board, UnitType type, int unit);
+
+/**
+ * Fills the candidates set with the legal values of the cell at the given
+ * coordinates, i.e. the values not used by any of the cell's neighbors (cells
+ * in the same row, column or block). The cell's own value is a candidate
+ * only if no neighbor shares it.
+ * @param board: the board to get the cells data from.
+ * @param candidates: the set to be filled with the cell's legal values.
+ * @param row: the index of the cell's row (zero-based).
+ * @param column: the index of the cell's column (zero-based).
+ */
+void get_cell_candidates(const Board *board, ValueSet *candidates, int row, int column);
+
+/**
+ * Fills the values set with the values that are used by at least one cell of
+ * the board.
  * @param board: the board to get the cells data from.
- * @param marks: an array of size board.dim to be filled according to the
- * neighbors' values (true means there is a neighbor with that value, and false
- * means there isn't). Note the indices are shifted by 1 as explained above.
+ * @param values: the set to be filled with the used values.
+ */
+void get_used_values(const Board *board, ValueSet *values);
+
+/**
+ * Checks if the given value is legal for the cell at the given coordinates,
+ * i.e. no neighbor of the cell has that value.
+ * @param board: the board to check.
  * @param row: the index of the cell's row (zero-based).
  * @param column: the index of the cell's column (zero-based).
+ * @param value: the value to check (1-based).
+ * @return: true if the value is legal for the cell, and false otherwise.
  */
-void mark_neighboring_values(Board *board, bool *marks, int row, int column);
+bool is_legal_value(const Board *board, int row, int column, int value);
 
 /**
  * If the given cell has only one legal value, returns it. Otherwise, returns ERROR_VALUE.
  * @param board: the board to get the cells data from.
- * @param marks: an array of size board.dim to be filled according to the
- * neighbors' values, and used to determine the legal values for the given cell.
  * @param row: the index of the cell's row (zero-based).
  * @param column: the index of the cell's column (zero-based).
  * @return: the only legal value if one exists, and ERROR_VALUE otherwise.
  */
-int get_obvious_value(Board *board, bool *marks, int row, int column);
-
+int get_obvious_value(const Board *board, int row, int column);
 
 
 /* Board manipulation functions */
@@ -142,12 +232,51 @@ void set_cell_value(Board *board, int row, int column, int value);
 bool fix_cell(Board *board, int row, int column);
 
 /**
- * Returns a copy of the given board (deep copy)
+ * Returns a copy of the given board (deep copy). The board's state is copied
+ * in bulk, so this can be used to take a snapshot of the board.
  * @param board: the board to copy.
  * @return: the copy of the given board.
  */
 Board* get_board_copy(const Board *board);
 
+/**
+ * Restores the state of the board (values, fixed cells and counters) to the
+ * state of the given snapshot, without any allocations. Allows reusing a
+ * scratch board across searches. Also closes all the levels of the board's
+ * trail.
+ * @param board: the board to restore.
+ * @param snapshot: the board to restore the state from (for example a copy
+ * made with get_board_copy). Must have the same dimensions as the board.
+ */
+void restore_board(Board *board, const Board *snapshot);
+
+
+/* Trail functions (undoing changes, for search algorithms) */
+
+/**
+ * Opens a new level on the board's trail. While at least one level is open,
+ * every change of a cell value is recorded on the trail, so it can be undone
+ * with pop_level. The trail is a preallocated array, so recording a change
+ * doesn't allocate memory.
+ * @param board: the board to open a level on.
+ */
+void push_level(Board *board);
+
+/**
+ * Closes the last level that was opened, and undoes all the cell value
+ * changes that were made since it was opened (in reverse order). Takes time
+ * proportional to the number of changes that are undone.
+ * @param board: the board to close the level on.
+ */
+void pop_level(Board *board);
+
+/**
+ * Gets the number of open levels on the board's trail.
+ * @param board: the board to check.
+ * @return: the number of open levels (0 if changes are not being recorded).
+ */
+int get_level(const Board *board);
+
 /**
  * Sets all non-empty cells in the given board to fixed. Returns
  * @param board: the board to update.
@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "Count.h"
+#include "../MemoryError.h"
+
+#define LIMB_BASE (1000000000UL)
+#define LIMB_DIGITS (9)
+#define MAX_UINT64_LIMBS (3)    /* 2^64 has 20 decimal digits */
+
+
+void init_count(Count *count) {
+    count->value = 0;
+    count->_limbs = NULL;
+    count->_num_of_limbs = 0;
+    count->_capacity = 0;
+}
+
+void free_count(Count *count) {
+    free(count->_limbs);
+    init_count(count);
+}
+
+/* Grows the limbs array of the count to hold at least the given number of limbs. */
+void reserve_limbs(Count *count, int num_of_limbs) {
+    if (count->_capacity >= num_of_limbs) {
+        return;
+    }
+
+    count->_capacity = (2 * count->_capacity > num_of_limbs) ? 2 * count->_capacity : num_of_limbs;
+    count->_limbs = realloc(count->_limbs, count->_capacity * sizeof(unsigned long));
+    validate_memory_allocation("reserve_limbs", count->_limbs);
+}
+
+/* Splits a 64-bit value into base 10^9 limbs, and returns their number. */
+int get_value_limbs(uint64_t value, unsigned long *limbs) {
+    int num_of_limbs = 0;
+
+    do {
+        limbs[num_of_limbs++] = (unsigned long) (value % LIMB_BASE);
+        value /= LIMB_BASE;
+    } while (value > 0);
+    return num_of_limbs;
+}
+
+/* Switches the count to its arbitrary precision representation. */
+void make_big(Count *count) {
+    if (count->_num_of_limbs > 0) {
+        return;
+    }
+    reserve_limbs(count, MAX_UINT64_LIMBS);
+    count->_num_of_limbs = get_value_limbs(count->value, count->_limbs);
+}
+
+/* Switches a big count back to its 64-bit value, if it fits in one. Keeps
+ * every count in limbs larger than any uint64_t. */
+void fit_count_value(Count *count) {
+    int i;
+    uint64_t value = 0;
+
+    if (count->_num_of_limbs == 0 || count->_num_of_limbs > MAX_UINT64_LIMBS) {
+        return;
+    }
+    for (i = count->_num_of_limbs - 1; i >= 0; i--) {
+        if (value > (UINT64_MAX - count->_limbs[i]) / LIMB_BASE) {
+            return; /* doesn't fit */
+        }
+        value = value * LIMB_BASE + count->_limbs[i];
+    }
+    count->value = value;
+    count->_num_of_limbs = 0;
+}
+
+/* Adds the given limbs to the limbs of a (big) count. */
+void add_limbs(Count *count, const unsigned long *limbs, int num_of_limbs) {
+    int i, size = (count->_num_of_limbs > num_of_limbs) ? count->_num_of_limbs : num_of_limbs;
+    unsigned long carry = 0, sum;
+
+    reserve_limbs(count, size + 1);
+    for (i = count->_num_of_limbs; i < size; i++) {
+        count->_limbs[i] = 0;
+    }
+
+    for (i = 0; i < size; i++) {
+        sum = count->_limbs[i] + carry + ((i < num_of_limbs) ? limbs[i] : 0);
+        carry = (sum >= LIMB_BASE) ? 1 : 0;
+        count->_limbs[i] = sum - carry * LIMB_BASE;
+    }
+    if (carry > 0) {
+        count->_limbs[size++] = carry;
+    }
+    count->_num_of_limbs = size;
+    fit_count_value(count);
+}
+
+void set_count_value(Count *count, uint64_t value) {
+    count->value = value;
+    count->_num_of_limbs = 0;
+}
+
+void set_count(Count *count, const Count *other) {
+    int i;
+
+    count->value = other->value;
+    count->_num_of_limbs = 0;
+    if (other->_num_of_limbs > 0) {
+        reserve_limbs(count, other->_num_of_limbs);
+        for (i = 0; i < other->_num_of_limbs; i++) {
+            count->_limbs[i] = other->_limbs[i];
+        }
+        count->_num_of_limbs = other->_num_of_limbs;
+    }
+}
+
+void add_to_count(Count *count, uint64_t value) {
+    unsigned long limbs[MAX_UINT64_LIMBS];
+
+    if (count->_num_of_limbs == 0 && value <= UINT64_MAX - count->value) {
+        count->value += value;
+        return;
+    }
+
+    make_big(count);
+    add_limbs(count, limbs, get_value_limbs(value, limbs));
+}
+
+void add_count(Count *count, const Count *other) {
+    if (other == count) {
+        multiply_count(count, 2); /* the limbs could move while adding */
+        return;
+    }
+    if (other->_num_of_limbs == 0) {
+        add_to_count(count, other->value);
+        return;
+    }
+
+    make_big(count);
+    add_limbs(count, other->_limbs, other->_num_of_limbs);
+}
+
+void multiply_count(Count *count, unsigned int factor) {
+    int i;
+    uint64_t product, carry = 0;
+
+    if (count->_num_of_limbs == 0) {
+        if (factor == 0 || count->value <= UINT64_MAX / factor) {
+            count->value *= factor;
+            return;
+        }
+        make_big(count);
+    }
+
+    /* a limb times a factor (plus carry) is below 10^9 * 2^32 + 2^32 < 2^64 */
+    for (i = 0; i < count->_num_of_limbs; i++) {
+        product = (uint64_t) count->_limbs[i] * factor + carry;
+        count->_limbs[i] = (unsigned long) (product % LIMB_BASE);
+        carry = product / LIMB_BASE;
+    }
+    while (carry > 0) {
+        reserve_limbs(count, count->_num_of_limbs + 1);
+        count->_limbs[count->_num_of_limbs++] = (unsigned long) (carry % LIMB_BASE);
+        carry /= LIMB_BASE;
+    }
+
+    /* drop leading zero limbs (when multiplying by 0) */
+    while (count->_num_of_limbs > 1 && count->_limbs[count->_num_of_limbs - 1] == 0) {
+        count->_num_of_limbs--;
+    }
+    fit_count_value(count);
+}
+
+void add_count_product(Count *count, const Count *other, unsigned int factor) {
+    Count product;
+
+    if (other->_num_of_limbs == 0 && (factor == 0 || other->value <= UINT64_MAX / factor)) {
+        add_to_count(count, other->value * factor);
+        return;
+    }
+
+    init_count(&product);
+    set_count(&product, other);
+    multiply_count(&product, factor);
+    add_count(count, &product);
+    free_count(&product);
+}
+
+bool is_count_at_least(const Count *count, uint64_t value) {
+    /* a count in limbs doesn't fit in 64 bits, so it's larger than any value */
+    return count->_num_of_limbs > 0 || count->value >= value;
+}
+
+char* count_to_string(const Count *count) {
+    unsigned long value_limbs[MAX_UINT64_LIMBS];
+    const unsigned long *limbs = count->_limbs;
+    int i, length, num_of_limbs = count->_num_of_limbs;
+    char *str;
+
+    if (num_of_limbs == 0) {
+        limbs = value_limbs;
+        num_of_limbs = get_value_limbs(count->value, value_limbs);
+    }
+
+    str = malloc(num_of_limbs * LIMB_DIGITS + 1);
+    validate_memory_allocation("count_to_string", str);
+
+    /* the most significant limb without leading zeros, the rest padded */
+    length = sprintf(str, "%lu", limbs[num_of_limbs - 1]);
+    for (i = num_of_limbs - 2; i >= 0; i--) {
+        length += sprintf(str + length, "%09lu", limbs[i]);
+    }
+    return str;
+}
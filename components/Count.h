@@ -0,0 +1,98 @@
+#ifndef FINAL_PROJECT_COUNT_H
+#define FINAL_PROJECT_COUNT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Count:
+ *
+ *  The component is a non-negative integer counter that doesn't overflow,
+ *  used for counting solutions. While the count fits in 64 bits it's kept in
+ *  a single uint64_t, so the common updates are a few machine instructions.
+ *  Once it doesn't, the count switches to arbitrary precision (base 10^9
+ *  limbs), and back to 64 bits if it fits in them again (e.g. multiplied by
+ *  0), so a count in limbs is always larger than any uint64_t.
+ *  A Count must be initialized with init_count before it's used, and freed
+ *  with free_count.
+ */
+
+typedef struct {
+    uint64_t value;             /* the count, while it fits in 64 bits */
+    unsigned long *_limbs;      /* the base 10^9 digits of the count (least significant first), once it doesn't */
+    int _num_of_limbs;          /* 0 while the count fits in value */
+    int _capacity;              /* the number of limbs that can be held without growing */
+} Count;
+
+/**
+ * Initializes the given count to zero.
+ * @param count: the count to initialize.
+ */
+void init_count(Count *count);
+
+/**
+ * Frees the memory held by the given count (the count itself isn't freed).
+ * The count must be initialized again before it's reused.
+ * @param count: the count to free.
+ */
+void free_count(Count *count);
+
+/**
+ * Sets the count to the given value.
+ * @param count: the count to update.
+ * @param value: the new value.
+ */
+void set_count_value(Count *count, uint64_t value);
+
+/**
+ * Sets the count to the value of another count.
+ * @param count: the count to update.
+ * @param other: the count to copy the value of.
+ */
+void set_count(Count *count, const Count *other);
+
+/**
+ * Adds the given value to the count.
+ * @param count: the count to update.
+ * @param value: the value to add.
+ */
+void add_to_count(Count *count, uint64_t value);
+
+/**
+ * Adds the value of another count to the count.
+ * @param count: the count to update.
+ * @param other: the count to add.
+ */
+void add_count(Count *count, const Count *other);
+
+/**
+ * Adds the value of another count, multiplied by the given factor, to the count.
+ * @param count: the count to update.
+ * @param other: the count to add.
+ * @param factor: the factor to multiply the other count by.
+ */
+void add_count_product(Count *count, const Count *other, unsigned int factor);
+
+/**
+ * Multiplies the count by the given factor.
+ * @param count: the count to update.
+ * @param factor: the factor to multiply by.
+ */
+void multiply_count(Count *count, unsigned int factor);
+
+/**
+ * Checks if the count is at least the given value.
+ * @param count: the count to check.
+ * @param value: the value to compare to.
+ * @return: true if the count is greater than or equal to the value, and false
+ * otherwise.
+ */
+bool is_count_at_least(const Count *count, uint64_t value);
+
+/**
+ * Returns the decimal representation of the count.
+ * @param count: the count to convert.
+ * @return: a new string with the count's digits (to be freed by the caller).
+ */
+char* count_to_string(const Count *count);
+
+#endif
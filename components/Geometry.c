@@ -0,0 +1,91 @@
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "Geometry.h"
+#include "ValueSet.h"
+#include "../MemoryError.h"
+
+#define NUM_OF_UNIT_TYPES (3)
+
+
+/* The geometries built so far, by [rows_in_block][columns_in_block]. */
+static Geometry *geometries[MAX_DIM + 1][MAX_DIM + 1];
+static pthread_mutex_t geometries_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* Fills the cells of all the units (rows, columns and blocks), and the block
+ * index of each cell. */
+void fill_units(Geometry *geometry) {
+    int row, column, block, i, dim = geometry->dim;
+    int rows = geometry->num_of_rows_in_block, columns = geometry->num_of_columns_in_block;
+
+    for (row = 0; row < dim; row++) {
+        for (column = 0; column < dim; column++) {
+            geometry->units[(row_unit * dim + row) * dim + column] = row * dim + column;
+            geometry->units[(column_unit * dim + column) * dim + row] = row * dim + column;
+        }
+    }
+
+    for (block = 0; block < dim; block++) {
+        for (i = 0; i < dim; i++) {
+            row = (block / rows) * rows + i / columns;
+            column = (block % rows) * columns + i % columns;
+            geometry->units[(block_unit * dim + block) * dim + i] = row * dim + column;
+            geometry->blocks[row * dim + column] = block;
+        }
+    }
+}
+
+/* Creates and fills a new geometry of the given shape. */
+Geometry* create_geometry(int rows_in_block, int columns_in_block) {
+    Geometry *geometry = malloc(sizeof(Geometry));
+    validate_memory_allocation("create_geometry", geometry);
+
+    geometry->num_of_rows_in_block = rows_in_block;
+    geometry->num_of_columns_in_block = columns_in_block;
+    geometry->dim = rows_in_block * columns_in_block;
+    geometry->num_of_cells = geometry->dim * geometry->dim;
+
+    geometry->blocks = malloc(geometry->num_of_cells * sizeof(int));
+    validate_memory_allocation("create_geometry", geometry->blocks);
+    geometry->units = malloc(NUM_OF_UNIT_TYPES * geometry->num_of_cells * sizeof(int));
+    validate_memory_allocation("create_geometry", geometry->units);
+
+    fill_units(geometry);
+    return geometry;
+}
+
+/* Destroys the given geometry (frees all related memory). */
+void destroy_geometry(Geometry *geometry) {
+    free(geometry->blocks);
+    free(geometry->units);
+    free(geometry);
+}
+
+const Geometry* get_geometry(int rows_in_block, int columns_in_block) {
+    Geometry *geometry;
+
+    pthread_mutex_lock(&geometries_lock);
+    if (geometries[rows_in_block][columns_in_block] == NULL) {
+        geometries[rows_in_block][columns_in_block] = create_geometry(rows_in_block, columns_in_block);
+    }
+    geometry = geometries[rows_in_block][columns_in_block];
+    pthread_mutex_unlock(&geometries_lock);
+
+    return geometry;
+}
+
+void release_geometries() {
+    int rows, columns;
+
+    pthread_mutex_lock(&geometries_lock);
+    for (rows = 0; rows <= MAX_DIM; rows++) {
+        for (columns = 0; columns <= MAX_DIM; columns++) {
+            if (geometries[rows][columns] != NULL) {
+                destroy_geometry(geometries[rows][columns]);
+                geometries[rows][columns] = NULL;
+            }
+        }
+    }
+    pthread_mutex_unlock(&geometries_lock);
+}
@@ -0,0 +1,45 @@
+#ifndef FINAL_PROJECT_GEOMETRY_H
+#define FINAL_PROJECT_GEOMETRY_H
+
+/** Geometry:
+ *
+ *  The component holds the index tables that only depend on the shape of a
+ *  board (the number of rows and columns in a block): the block of each cell,
+ *  and the cells of each unit (row, column or block).
+ *  A Geometry is built once per shape, and then shared read-only by all the
+ *  boards of that shape for the rest of the process. Getting a Geometry is
+ *  safe from multiple threads.
+ *  Cells are indexed by row * dim + column.
+ */
+
+typedef enum {
+    row_unit,
+    column_unit,
+    block_unit
+} UnitType;
+
+typedef struct {
+    int num_of_rows_in_block;
+    int num_of_columns_in_block;
+    int dim;
+    int num_of_cells;
+    int *blocks;        /* the block index of each cell */
+    int *units;         /* the cells of each unit ([(type * dim + unit) * dim + i], see UnitType) */
+} Geometry;
+
+/**
+ * Gets the shared Geometry of boards with the given block shape, and builds
+ * it if this is the first time it is requested.
+ * @param rows_in_block: the number of rows in a single block.
+ * @param columns_in_block: the number of columns in a single block.
+ * @return: the Geometry of the given shape. Must not be modified or freed.
+ */
+const Geometry* get_geometry(int rows_in_block, int columns_in_block);
+
+/**
+ * Releases all the Geometries that were built (frees all related memory).
+ * To be used once, before the process exits.
+ */
+void release_geometries();
+
+#endif
@@ -7,8 +7,6 @@
  *
  *  The component is a generic implementation of a doubly-linked-list.
  *  It is used as the main data type in the StatesList, and Move components.
- *  Also used in the Board component to maintain the lists of neighbors, and
- *  of conflicting cells.
  */
 
 typedef struct Node Node;
@@ -0,0 +1,7 @@
+#include "SplitMix64.h"
+
+uint64_t mix_splitmix_bits(uint64_t value) {
+    value = (value ^ (value >> 30)) * MAKE_UINT64(0xBF58476DUL, 0x1CE4E5B9UL);
+    value = (value ^ (value >> 27)) * MAKE_UINT64(0x94D049BBUL, 0x133111EBUL);
+    return value ^ (value >> 31);
+}
@@ -0,0 +1,26 @@
+#ifndef FINAL_PROJECT_SPLITMIX64_H
+#define FINAL_PROJECT_SPLITMIX64_H
+
+#include <stdint.h>
+
+/** SplitMix64:
+ *
+ *  The component is the SplitMix64 generator's steps: its state advances by
+ *  SPLITMIX_GAMMA, and each output is the state with its bits mixed. It gives
+ *  the Board component its hash keys (computed directly from their index),
+ *  and the random module its per-thread generators.
+ */
+
+#define MAKE_UINT64(high, low) (((uint64_t) (high) << 32) | (uint64_t) (low)) /* C90 has no 64-bit literals */
+#define SPLITMIX_GAMMA MAKE_UINT64(0x9E3779B9UL, 0x7F4A7C15UL)
+
+/**
+ * Mixes the bits of a 64-bit value, as SplitMix64 does to get each output
+ * from its state. Consecutive states give well distributed, independent
+ * looking outputs.
+ * @param value: the value to mix.
+ * @return: the mixed value.
+ */
+uint64_t mix_splitmix_bits(uint64_t value);
+
+#endif
@@ -4,60 +4,54 @@
 #include "../MemoryError.h"
 
 
-Stack* create_stack() {
+Stack* create_stack(int capacity) {
     Stack *stack = (Stack*) malloc(sizeof(Stack));
     validate_memory_allocation("create_stack", stack);
 
-    stack->top = NULL;
+    stack->capacity = (capacity > 0) ? capacity : 1;
+    stack->size = 0;
+    stack->nodes = (StackNode*) malloc(stack->capacity * sizeof(StackNode));
+    validate_memory_allocation("create_stack", stack->nodes);
     return stack;
 }
 
-StackNode* create_stack_node(int row, int column, int val) {
-    StackNode *stack_node = (StackNode*) malloc(sizeof(StackNode));
-    validate_memory_allocation("create_stack_node", stack_node);
-
-    stack_node->row = row;
-    stack_node->column = column;
-    stack_node->val = val;
+void push(int row, int column, int val, Stack *stack) {
+    StackNode *new_top;
 
-    return stack_node;
-}
+    if (stack->size == stack->capacity) {
+        stack->capacity *= 2;
+        stack->nodes = (StackNode*) realloc(stack->nodes, stack->capacity * sizeof(StackNode));
+        validate_memory_allocation("push", stack->nodes);
+    }
 
-void push(int row, int column, int val, Stack *stack) {
-    StackNode *new_top = create_stack_node(row, column, val);
-    new_top->next = stack->top;
-    stack->top = new_top;
+    new_top = &stack->nodes[stack->size];
+    new_top->row = row;
+    new_top->column = column;
+    new_top->val = val;
+    stack->size++;
 }
 
 StackNode* pop(Stack *stack) {
-    StackNode *res_node;
-
     if (is_stack_empty(stack)) {
         return NULL;
     }
 
-    res_node = top(stack);
-    stack->top = stack->top->next;
-    return res_node;
+    stack->size--;
+    return &stack->nodes[stack->size];
 }
 
 StackNode* top(Stack *stack) {
-    return stack->top;
+    if (is_stack_empty(stack)) {
+        return NULL;
+    }
+    return &stack->nodes[stack->size - 1];
 }
 
 bool is_stack_empty(Stack *stack) {
-    return (top(stack) == NULL);
-}
-
-void destroy_stack_node(StackNode *node) {
-    free(node);
+    return (stack->size == 0);
 }
 
 void destroy_stack(Stack *stack) {
-    StackNode *node;
-    while (!is_stack_empty(stack)) {
-        node = pop(stack);
-        destroy_stack_node(node);
-    }
+    free(stack->nodes);
     free(stack);
 }
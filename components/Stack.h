@@ -9,33 +9,28 @@
  *  backtracking algorithm. It's a generic stack that supports pop, push
  *  and top. The stack nodes are specific to the backtracking algorithm
  *  requirements.
+ *  The nodes are kept in a preallocated array (which grows only when it's
+ *  full), so pushing and popping don't allocate memory.
  */
 
-typedef struct StackNode_ {
+typedef struct {
     int row;
     int column;
     int val;
-    struct StackNode_ *next;
 } StackNode;
 
 typedef struct{
-    StackNode *top;
+    StackNode *nodes;
+    int size;
+    int capacity;
 } Stack;
 
 /**
  * Creates a new empty stack.
+ * @param capacity: the number of nodes to preallocate.
  * @return: the new stack that was created.
  */
-Stack* create_stack();
-
-/**
- * Creates a new stack node.
- * @param row: the row to pass to the stack node.
- * @param column: the column to pass to the stack node.
- * @param val: the value to pass to the stack node.
- * @return: the new stack node that was created.
- */
-StackNode* create_stack_node(int row, int column, int val);
+Stack* create_stack(int capacity);
 
 /**
  * Pushes a new node to the stack.
@@ -49,7 +44,8 @@ void push(int row, int column, int val, Stack *stack);
 /**
  * Removes the top node of the stack, and returns it.
  * @param stack: the stack to remove the top node from.
- * @return: the removed node.
+ * @return: the removed node (valid until the next push), or NULL if the stack
+ * is empty.
  */
 StackNode* pop(Stack *stack);
 
@@ -67,12 +63,6 @@ StackNode* top(Stack *stack);
  */
 bool is_stack_empty(Stack *stack);
 
-/**
- * Destroys the given stack node (frees all related memory).
- * @param node: the node to be destroyed.
- */
-void destroy_stack_node(StackNode *node);
-
 /**
  * Destroys the given stack (frees all related memory).
  * @param stack: the stack to be destroyed.
@@ -0,0 +1,125 @@
+#include "ValueSet.h"
+
+#define WORD_INDEX(value) (((unsigned int) (value) - 1) / VALUE_SET_WORD_BITS)
+#define BIT_MASK(value) (1UL << (((unsigned int) (value) - 1) % VALUE_SET_WORD_BITS))
+
+
+/* Counts the set bits of a single word. */
+int count_word_bits(unsigned long word) {
+#ifdef __GNUC__
+    return __builtin_popcountl(word);
+#else
+    int count = 0;
+    while (word != 0) {
+        word &= word - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/* Returns the index of the lowest set bit of a (non-zero) word. */
+int lowest_word_bit(unsigned long word) {
+#ifdef __GNUC__
+    return __builtin_ctzl(word);
+#else
+    int index = 0;
+    while ((word & 1UL) == 0) {
+        word >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+void clear_value_set(ValueSet *set) {
+    unsigned int i;
+    for (i = 0; i < VALUE_SET_WORDS; i++) {
+        set->words[i] = 0UL;
+    }
+}
+
+void fill_value_set(ValueSet *set, int dim) {
+    unsigned int i, bits;
+
+    for (i = 0; i < VALUE_SET_WORDS; i++) {
+        bits = (dim > (int) (i * VALUE_SET_WORD_BITS)) ? (unsigned int) dim - i * VALUE_SET_WORD_BITS : 0;
+        if (bits >= VALUE_SET_WORD_BITS) {
+            set->words[i] = ~0UL;
+        } else {
+            set->words[i] = (1UL << bits) - 1UL;
+        }
+    }
+}
+
+void add_value(ValueSet *set, int value) {
+    set->words[WORD_INDEX(value)] |= BIT_MASK(value);
+}
+
+void remove_value(ValueSet *set, int value) {
+    set->words[WORD_INDEX(value)] &= ~BIT_MASK(value);
+}
+
+void add_value_set(ValueSet *set, const ValueSet *other) {
+    unsigned int i;
+    for (i = 0; i < VALUE_SET_WORDS; i++) {
+        set->words[i] |= other->words[i];
+    }
+}
+
+bool contains_value(const ValueSet *set, int value) {
+    return (set->words[WORD_INDEX(value)] & BIT_MASK(value)) != 0;
+}
+
+int count_values(const ValueSet *set) {
+    unsigned int i;
+    int count = 0;
+
+    for (i = 0; i < VALUE_SET_WORDS; i++) {
+        count += count_word_bits(set->words[i]);
+    }
+    return count;
+}
+
+int get_next_value(const ValueSet *set, int value) {
+    unsigned int i = (unsigned int) value / VALUE_SET_WORD_BITS;
+    unsigned int shift = (unsigned int) value % VALUE_SET_WORD_BITS;
+    unsigned long word;
+
+    if (i >= VALUE_SET_WORDS) {
+        return 0;
+    }
+
+    /* bit 'value' is the bit of value+1 (the first candidate), mask out lower bits */
+    word = set->words[i] & (~0UL << shift);
+    while (word == 0) {
+        i++;
+        if (i >= VALUE_SET_WORDS) {
+            return 0;
+        }
+        word = set->words[i];
+    }
+    return (int) (i * VALUE_SET_WORD_BITS) + lowest_word_bit(word) + 1;
+}
+
+int get_nth_value(const ValueSet *set, int n) {
+    unsigned int i;
+    int bits;
+    unsigned long word;
+
+    for (i = 0; i < VALUE_SET_WORDS; i++) {
+        word = set->words[i];
+        bits = count_word_bits(word);
+        if (n >= bits) {
+            n -= bits;
+            continue;
+        }
+
+        while (n > 0) {
+            word &= word - 1; /* drop the lowest set bit */
+            n--;
+        }
+        return (int) (i * VALUE_SET_WORD_BITS) + lowest_word_bit(word) + 1;
+    }
+    return 0;
+}
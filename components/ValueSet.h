@@ -0,0 +1,91 @@
+#ifndef FINAL_PROJECT_VALUESET_H
+#define FINAL_PROJECT_VALUESET_H
+
+#include <stdbool.h>
+#include <limits.h>
+
+/** ValueSet:
+ *
+ *  The component is a fixed-size bitmask over the values of a board (1-based).
+ *  It is used by the Board component to keep the values used by each row,
+ *  column and block, and to answer legal-value (candidate) queries with a few
+ *  word operations instead of walking the cell's neighbors.
+ */
+
+/* The largest board dimension a ValueSet can represent. */
+#define MAX_DIM (99)
+
+#define VALUE_SET_WORD_BITS (CHAR_BIT * sizeof(unsigned long))
+#define VALUE_SET_WORDS ((MAX_DIM + VALUE_SET_WORD_BITS - 1) / VALUE_SET_WORD_BITS)
+
+typedef struct {
+    unsigned long words[VALUE_SET_WORDS];
+} ValueSet;
+
+/**
+ * Clears the given set (removes all values).
+ * @param set: the set to clear.
+ */
+void clear_value_set(ValueSet *set);
+
+/**
+ * Fills the given set with all the values between 1 and dim (inclusive).
+ * @param set: the set to fill.
+ * @param dim: the largest value to add to the set.
+ */
+void fill_value_set(ValueSet *set, int dim);
+
+/**
+ * Adds a value to the set.
+ * @param set: the set to update.
+ * @param value: the value to add (1-based).
+ */
+void add_value(ValueSet *set, int value);
+
+/**
+ * Removes a value from the set.
+ * @param set: the set to update.
+ * @param value: the value to remove (1-based).
+ */
+void remove_value(ValueSet *set, int value);
+
+/**
+ * Adds all the values of another set to the set (set union).
+ * @param set: the set to update.
+ * @param other: the set of values to add.
+ */
+void add_value_set(ValueSet *set, const ValueSet *other);
+
+/**
+ * Checks if the set contains the given value.
+ * @param set: the set to check.
+ * @param value: the value to look for (1-based).
+ * @return: true if the value is in the set, and false otherwise.
+ */
+bool contains_value(const ValueSet *set, int value);
+
+/**
+ * Counts the values in the set.
+ * @param set: the set to count.
+ * @return: the number of values in the set.
+ */
+int count_values(const ValueSet *set);
+
+/**
+ * Gets the smallest value in the set that is larger than the given value.
+ * Passing CLEAR (0) returns the smallest value in the set.
+ * @param set: the set to search.
+ * @param value: the value to start the search after.
+ * @return: the next value in the set, or 0 if no such value exists.
+ */
+int get_next_value(const ValueSet *set, int value);
+
+/**
+ * Gets the n-th smallest value in the set.
+ * @param set: the set to search.
+ * @param n: the index of the value to get (zero-based).
+ * @return: the n-th value in the set, or 0 if the set is too small.
+ */
+int get_nth_value(const ValueSet *set, int n);
+
+#endif
@@ -22,6 +22,8 @@ Command* create_command() {
     command->data.save = NULL;
     command->data.hint = NULL;
     command->data.guess_hint = NULL;
+    command->data.num_solutions = NULL;
+    command->data.backend = NULL;
     command->_play = NULL;
     command->_validate = NULL;
     command->_parse_args = NULL;
@@ -60,6 +62,13 @@ void destroy_command(Command* command) {
     else if (command->type == guess_hint) {
         free(command->data.guess_hint);
     }
+    else if (command->type == num_solutions) {
+        free(command->data.num_solutions);
+    }
+    else if (command->type == backend && command->data.backend != NULL) {
+        free(command->data.backend->name);
+        free(command->data.backend);
+    }
     destroy_error(command->error);
     free(command);
 }
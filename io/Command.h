@@ -2,6 +2,7 @@
 #define FINAL_PROJECT_COMMAND_H
 
 #include <stdbool.h>
+#include <limits.h>
 #include "../components/Game.h"
 #include "Error.h"
 
@@ -20,6 +21,10 @@
 #define SAVE_ARGS 1
 #define HINT_ARGS 2
 #define GUESS_HINT_ARGS 2
+#define NUM_SOLUTIONS_MIN_ARGS 0
+#define NUM_SOLUTIONS_MAX_ARGS 1
+#define BACKEND_MIN_ARGS 0
+#define BACKEND_MAX_ARGS 1
 
 /* Command format per command type */
 #define SOLVE_FORMAT "solve <path>"
@@ -35,15 +40,18 @@
 #define SAVE_FORMAT "save <path>"
 #define HINT_FORMAT "hint <column> <row>"
 #define GUESS_HINT_FORMAT "guess_hint <column> <row>"
-#define NUM_SOLUTIONS_FORMAT "num_solutions"
+#define NUM_SOLUTIONS_FORMAT "num_solutions [<max>]"
 #define AUTOFILL_FORMAT "autofill"
 #define RESET_FORMAT "reset"
+#define BACKEND_FORMAT "backend [<name>]"
 #define EXIT_FORMAT "exit"
 
 /* Numeric arguments' limits */
 #define MIN_THRESHOLD 0
 #define MAX_THRESHOLD 1
 #define MIN_CELLS 1
+#define MIN_SOLUTIONS_LIMIT 1
+#define MAX_SOLUTIONS_LIMIT INT_MAX
 
 /* Allowed game modes per command type */
 #define SOLVE_MODES (solve_mode + edit_mode + init_mode)
@@ -62,12 +70,13 @@
 #define NUM_SOLUTIONS_MODES (solve_mode + edit_mode)
 #define AUTOFILL_MODES (solve_mode)
 #define RESET_MODES (solve_mode + edit_mode)
+#define BACKEND_MODES (solve_mode + edit_mode + init_mode)
 #define EXIT_MODES (solve_mode + edit_mode + init_mode)
 
 
 /* The possible types of commands ('empty' refers to a non-command that should be ignored) */
 typedef enum { solve, edit, mark_errors, print_board, set, validate, guess, generate, undo, redo, save, hint,
-    guess_hint, num_solutions, autofill, reset, exit_game, empty } CommandType;
+    guess_hint, num_solutions, autofill, reset, backend, exit_game, empty } CommandType;
 
 
 /* The different commands' additional data */
@@ -104,6 +113,15 @@ typedef struct {
     int column;
 } HintCommand, GuessHintCommand;
 
+typedef struct {
+    int max;
+    bool limited;
+} NumSolutionsCommand;
+
+typedef struct {
+    char* name;
+} BackendCommand;
+
 
 /* The command information such as the type of the command, and the command-specific data. */
 typedef struct Command_ {
@@ -120,6 +138,8 @@ typedef struct Command_ {
         SaveCommand *save;
         HintCommand *hint;
         GuessHintCommand *guess_hint;
+        NumSolutionsCommand *num_solutions;
+        BackendCommand *backend;
     } data;
     void (*_parse_args)(struct Command_*, char**, int);
     void (*_validate)(struct Command_*, Game *game);
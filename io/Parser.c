@@ -14,12 +14,13 @@
 #define INT_BASE 10
 #define ERROR_VALUE (-1)
 
-#define INVALID_COMMAND_INIT_ERROR "Error: invalid command. Available commands are: solve, edit, exit."
+#define INVALID_COMMAND_INIT_ERROR "Error: invalid command. Available commands are: solve, edit, backend, exit."
 #define INVALID_COMMAND_EDIT_ERROR "Error: invalid command. Available commands are: solve, edit, print_board, set, " \
-                                   "validate, generate, undo, redo, save, num_solutions, reset, exit."
+                                   "validate, generate, undo, redo, save, num_solutions, reset, backend, " \
+                                   "exit."
 #define INVALID_COMMAND_SOLVE_ERROR "Error: invalid command. Available commands are: solve, edit, mark_errors, " \
                                    "print_board, set, validate, guess, undo, redo, save, hint, guess_hint, " \
-                                   "num_solutions, autofill, reset, exit."
+                                   "num_solutions, autofill, reset, backend, exit."
 #define TOO_MANY_ARGS_ERROR "Error: too many arguments were given."
 #define TOO_FEW_ARGS_ERROR "Error: not enough arguments were given."
 
@@ -260,6 +261,50 @@ void guess_hint_args_parser(Command *self, char **args, int num_of_args) {
     self->data.guess_hint = data;
 }
 
+/* Parses the arguments of a num_solutions command. */
+void num_solutions_args_parser(Command *self, char **args, int num_of_args) {
+    NumSolutionsCommand *data = malloc(sizeof(NumSolutionsCommand));
+    validate_memory_allocation("num_solutions_args_parser", data);
+
+    assert_num_of_args(self, NUM_SOLUTIONS_MIN_ARGS, NUM_SOLUTIONS_MAX_ARGS, num_of_args);
+
+    if (!is_valid(self)) {
+        free(data);
+        return;
+    }
+
+    if (num_of_args == NUM_SOLUTIONS_MAX_ARGS) {
+        data->limited = true;
+        parse_int_arg(args[0], &data->max);
+    } else {
+        data->limited = false;
+        data->max = 0;
+    }
+    self->data.num_solutions = data;
+}
+
+/* Parses the arguments of a backend command. */
+void backend_args_parser(Command *self, char **args, int num_of_args) {
+    BackendCommand *data = malloc(sizeof(BackendCommand));
+    validate_memory_allocation("backend_args_parser", data);
+
+    assert_num_of_args(self, BACKEND_MIN_ARGS, BACKEND_MAX_ARGS, num_of_args);
+
+    if (!is_valid(self)) {
+        free(data);
+        return;
+    }
+
+    if (num_of_args == BACKEND_MAX_ARGS) {
+        data->name = calloc(strlen(args[0]) + 1, sizeof(char));
+        validate_memory_allocation("backend_args_parser", data->name);
+        strcpy(data->name, args[0]);
+    } else {
+        data->name = NULL;
+    }
+    self->data.backend = data;
+}
+
 /* A basic parser for commands with no additional arguments. */
 void basic_parser(Command *self, char **args, int num_of_args) {
     UNUSED(args);
@@ -374,6 +419,7 @@ void configure_by_type(Command *command, char *type_str, GameMode mode) {
         command->type = num_solutions;
         command->format = NUM_SOLUTIONS_FORMAT;
         command->modes = NUM_SOLUTIONS_MODES;
+        command->_parse_args = num_solutions_args_parser;
         command->_validate = num_solutions_validator;
         command->_play = play_num_solutions;
 
@@ -390,6 +436,14 @@ void configure_by_type(Command *command, char *type_str, GameMode mode) {
         command->modes = RESET_MODES;
         command->_play = play_reset;
 
+    } else if (strcmp(type_str, "backend") == 0) {
+        command->type = backend;
+        command->format = BACKEND_FORMAT;
+        command->modes = BACKEND_MODES;
+        command->_parse_args = backend_args_parser;
+        command->_validate = backend_validator;
+        command->_play = play_backend;
+
     } else if (strcmp(type_str, "exit") == 0) {
         command->type = exit_game;
         command->format = EXIT_FORMAT;
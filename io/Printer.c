@@ -102,12 +102,30 @@ void announce_game_not_solvable() {
     printf("Unfortunately the current state of the puzzle is not solvable.\n");
 }
 
+void announce_solution_uniqueness(bool unique) {
+    if (unique) {
+        printf("It has a single solution.\n");
+    } else {
+        printf("It has more than one solution.\n");
+    }
+}
+
 void announce_hint(int hint) {
     printf("Your hint is: %d. Use it wisely!\n", hint);
 }
 
-void announce_num_of_solutions(int num_of_solutions) {
-    printf("Number of solutions for the current state: %d\n", num_of_solutions);
+void announce_num_of_solutions(const Count *num_of_solutions, bool limit_reached) {
+    char *digits = count_to_string(num_of_solutions);
+    printf("Number of solutions for the current state: %s%s\n", limit_reached ? "at least " : "", digits);
+    free(digits);
+}
+
+void announce_num_of_search_nodes(unsigned long num_of_nodes) {
+    printf("Number of search nodes: %lu\n", num_of_nodes);
+}
+
+void announce_backend(const char *name, const char *available) {
+    printf("Solver backend: %s (available backends: %s)\n", name, available);
 }
 
 void announce_changes_made() {
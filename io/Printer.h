@@ -2,6 +2,7 @@
 #define FINAL_PROJECT_PRINTER_H
 
 #include "../components/Game.h"
+#include "../components/Count.h"
 #include "Error.h"
 
 /** Printer:
@@ -42,6 +43,12 @@ void announce_game_solvable();
  */
 void announce_game_not_solvable();
 
+/**
+ * Announces to the user whether the solvable game has a single solution.
+ * @param unique: true if the game has a single solution, and false otherwise.
+ */
+void announce_solution_uniqueness(bool unique);
+
 /**
  * Gives the user the information regarding the hint that was requested.
  * @param hint: the hint value to give to the user.
@@ -51,8 +58,23 @@ void announce_hint(int hint);
 /**
  * Tells the user how many solutions the current game has.
  * @param num_of_solutions: the number of solution of the current game.
+ * @param limit_reached: true if the counting stopped at a limit (so there may
+ * be more solutions), and false otherwise.
+ */
+void announce_num_of_solutions(const Count *num_of_solutions, bool limit_reached);
+
+/**
+ * Tells the user how many nodes the search for the solutions visited.
+ * @param num_of_nodes: the number of nodes (decisions) of the search.
+ */
+void announce_num_of_search_nodes(unsigned long num_of_nodes);
+
+/**
+ * Tells the user which solver backend is in use.
+ * @param name: the name of the backend in use.
+ * @param available: the names of the available backends.
  */
-void announce_num_of_solutions(int num_of_solutions);
+void announce_backend(const char *name, const char *available);
 
 /**
  * Announces to the user that changes were made. Further information about the
@@ -5,6 +5,7 @@
 
 #include "validators.h"
 #include "../MemoryError.h"
+#include "../logic/backend.h"
 
 #define FILE_DOESNT_EXIST_ERROR "Error: The given file doesn't exist!"
 #define FILE_NOT_READABLE_ERROR "Error: The given file cannot be read (no permission)."
@@ -27,6 +28,7 @@
 #define BOOL_RANGE "Must be either 0 or 1."
 #define INT_RANGE "Must be a valid integer between %d and %d."
 #define DOUBLE_RANGE "Must be a valid floating point number between %.1f and %.1f."
+#define NAME_RANGE "Must be one of: %s."
 
 #define UNUSED(x) (void)(x)
 
@@ -116,6 +118,23 @@ void assert_double_arg_in_range(Command *command, char *arg_name, double value,
     invalidate(command, error_message, invalid_arg_range, true);
 }
 
+/* Assert that a name argument is one of the allowed names (given as a
+ * comma-separated list). */
+void assert_name_arg_in_list(Command *command, char *arg_name, bool valid, const char *names) {
+    char *error_message, error_format[MAX_ERROR_MESSAGE_LEN] = {0};
+
+    if (valid) {
+        return; /* valid */
+    }
+
+    error_message = calloc(MAX_ERROR_MESSAGE_LEN, sizeof(char));
+    validate_memory_allocation("assert_name_arg_in_list", error_message);
+
+    strcat(strcpy(error_format, ARG_OUT_OF_RANGE_ERROR), NAME_RANGE);
+    sprintf(error_message, error_format, arg_name, names);
+    invalidate(command, error_message, invalid_arg_range, true);
+}
+
 /* Assert that the board is not currently erroneous. */
 void assert_board_not_erroneous(Command *command, Board *board) {
     if (board != NULL && is_board_erroneous(board)) {
@@ -276,6 +295,10 @@ void guess_hint_validator(Command *command, Game *game) {
 }
 
 void num_solutions_validator(Command *command, Game *game) {
+    if (command->data.num_solutions != NULL && command->data.num_solutions->limited) {
+        assert_int_arg_in_range(command, "max", command->data.num_solutions->max,
+                                MIN_SOLUTIONS_LIMIT, MAX_SOLUTIONS_LIMIT);
+    }
     assert_board_not_erroneous(command, game->board);
 }
 
@@ -283,6 +306,17 @@ void autofill_validator(Command *command, Game *game) {
     assert_board_not_erroneous(command, game->board);
 }
 
+void backend_validator(Command *command, Game *game) {
+    UNUSED(game);
+
+    if (command->data.backend == NULL || command->data.backend->name == NULL) {
+        return;
+    }
+
+    assert_name_arg_in_list(command, "name", is_backend_available(command->data.backend->name),
+                            get_backend_names());
+}
+
 
 /* main validation function */
 
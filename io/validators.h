@@ -139,6 +139,15 @@ void num_solutions_validator(Command *command, Game *game);
  */
 void autofill_validator(Command *command, Game *game);
 
+/**
+ * The custom validator for the backend command. In case the command is found to
+ * be invalid (if the backend name is unknown for example), the command's Error
+ * is updated to reflect the issue.
+ * @param command: the Command to validate.
+ * @param game: the current game.
+ */
+void backend_validator(Command *command, Game *game);
+
 /**
  * Validates the command - In case the command is found to be invalid (if the
  * game-mode is illegal for this command for example), the command's Error is
@@ -1,7 +1,7 @@
 #include <stdlib.h>
 
 #include "ILP.h"
-#include "solver.h"
+#include "backend.h"
 #include "../MemoryError.h"
 #include "random.h"
 
@@ -10,29 +10,37 @@
 
 
 bool solve_puzzle(Board *board, States *states) {
-    return gurobi_solver(board, states, integer, solve_board, NULL, 1.0);
-}
+    int row, column;
+    Board *solution;
 
-int get_cell_solution(const Board *board, int row, int column) {
-    Board* copy = get_board_copy(board);
-    int cell_solution;
+    if (states == NULL) {
+        return get_backend()->solve(board);
+    }
 
-    if (!solve_puzzle(copy, NULL)) {
-        destroy_board(copy);
-        return ERROR_VALUE;
+    /* solve a copy, so each filled cell can be recorded as a change */
+    solution = get_board_copy(board);
+    if (!get_backend()->solve(solution)) {
+        destroy_board(solution);
+        return false;
     }
 
-    cell_solution = get_cell_value(copy, row, column);
-    destroy_board(copy);
-    return cell_solution;
+    for (row = 0; row < board->dim; row++) {
+        for (column = 0; column < board->dim; column++) {
+            if (is_cell_empty(board, row, column)) {
+                make_change(board, states, row, column, get_cell_value(solution, row, column));
+            }
+        }
+    }
+    destroy_board(solution);
+    return true;
 }
 
-bool is_board_solvable(const Board *board) {
-    Board* copy = get_board_copy(board);
-    bool solvable = solve_puzzle(copy, NULL);
+int get_cell_solution(const Board *board, int row, int column) {
+    return get_backend()->get_cell_solution(board, row, column);
+}
 
-    destroy_board(copy);
-    return solvable;
+bool is_board_solvable(const Board *board) {
+    return get_backend()->is_solvable(board);
 }
 
 /* Gets the row & column coordinates from the board cell index. */
@@ -62,38 +70,25 @@ int* get_board_empty_cells_indices(Board *board) {
 
 /* Fills the given cell with a random legal value. Returns false if no legal
  * value exists, and true on success. */
-bool fill_cell_with_random_value(Board *board, States *states, bool *marks, int row, int column) {
-    int i, rand_index, possible_values_counter = 0;
-
-    mark_neighboring_values(board, marks, row, column);
-    /* count possible values */
-    for (i = 0; i < board->dim; i++) {
-        if (!marks[i]) {
-            possible_values_counter++;
-        }
-    }
+bool fill_cell_with_random_value(Board *board, States *states, int row, int column) {
+    int possible_values_counter;
+    ValueSet candidates;
+
+    get_cell_candidates(board, &candidates, row, column);
+    possible_values_counter = count_values(&candidates);
 
     if (possible_values_counter == 0) {
         return false;
     }
 
     /* fill cell with a random legal value */
-    rand_index = get_rand_index(possible_values_counter);
-    for (i = 0; i < board->dim; i++) {
-        if (!marks[i]) {
-            if (rand_index == 0) {
-                make_change(board, states, row, column, i+1);
-                return true;
-            }
-            rand_index--;
-        }
-    }
-    return false;
+    make_change(board, states, row, column, get_nth_value(&candidates, get_rand_index(possible_values_counter)));
+    return true;
 }
 
 
 /* Randomly chooses empty cells and fills them with legal values. */
-bool fill_board_randomly(Board *board, States *states, bool *marks, int num_to_fill) {
+bool fill_board_randomly(Board *board, States *states, int num_to_fill) {
     int i, row, column, trial_counter = 0, *indices_to_fill;
     bool trial_success = true;
 
@@ -106,7 +101,7 @@ bool fill_board_randomly(Board *board, States *states, bool *marks, int num_to_f
         for (i = 0; i < num_to_fill; i++) {
             get_coordinates(indices_to_fill[i], board->dim, &row, &column);
 
-            if (!fill_cell_with_random_value(board, states, marks, row, column)) {
+            if (!fill_cell_with_random_value(board, states, row, column)) {
                 trial_success = false;
                 reset_move(board, (Move*) get_current_item(states->moves));
                 break;
@@ -146,17 +141,10 @@ void clear_board_randomly(Board *board, States *states, int num_to_leave) {
 }
 
 bool generate_puzzle(Board *board, States *states, int num_to_fill, int num_to_leave) {
-    bool *marks;
-
-    marks = malloc(board->dim * sizeof(bool));
-    validate_memory_allocation("generate_puzzle", marks);
-
-    if (!fill_board_randomly(board, states, marks, num_to_fill)) {
-        free(marks);
+    if (!fill_board_randomly(board, states, num_to_fill)) {
         return false;
     }
     clear_board_randomly(board, states, num_to_leave);
-    free(marks);
     return true;
 }
 
@@ -8,8 +8,15 @@
 #define ERROR_VALUE (-1)
 
 
+/** ILP:
+ *
+ *  The exact solving functions of the game. The board is solved by the
+ *  selected solver backend (see backend.h), which is the built-in exact
+ *  solver by default.
+ */
+
 /**
- * Solves the board using ILP. Returns true if the board was solved
+ * Solves the board. Returns true if the board was solved
  * successfully, and false if it is not solvable.
  * @param board: the board to solve.
  * @param states: the states list to update with the solution. Can be NULL in
@@ -20,7 +27,7 @@
 bool solve_puzzle(Board *board, States *states);
 
 /**
- * Emulates solving the board using ILP. Returns the value of the solution
+ * Emulates solving the board. Returns the value of the solution
  * for the given cell. If the board is not solvable -1 is returned.
  * @param board: the board to solve.
  * @param row: the index of the cell's row (zero-based).
@@ -30,7 +37,7 @@ bool solve_puzzle(Board *board, States *states);
 int get_cell_solution(const Board *board, int row, int column);
 
 /**
- * Returns true is the board has a solution (validated using ILP), and false
+ * Returns true is the board has a solution (validated by solving it), and false
  * if it doesn't. This function does not change the board in any way.
  * @param board: the board to check.
  * @return: true is the board has a solution, and false if it doesn't.
@@ -41,7 +48,7 @@ bool is_board_solvable(const Board *board);
  * This function generates a puzzle in the following way:
  *  - Chooses <num_to_fill> random empty cells.
  *  - Fills the chosen cells with random legal values.
- *  - Solves the board using ILP (if it's unsolvable restart the process)
+ *  - Solves the board (if it's unsolvable restart the process)
  *  - Clear all but <num_to_leave> cells (any cells, unrelated to the
  *    previously chosen cells, or the ones that were originally filled).
  *
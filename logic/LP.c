@@ -3,30 +3,79 @@
 
 #include "LP.h"
 #include "../MemoryError.h"
-#include "solver.h"
+#include "backend.h"
+#include "random.h"
 
-#define UNUSED(x) (void)(x)
 
+/* Gets the scores of all the empty cells and values from the backend, or NULL
+ * if it found none. */
+double* get_board_scores(const Board *board) {
+    int dim = board->dim;
+    double *scores = malloc(dim * dim * dim * sizeof(double));
+    validate_memory_allocation("get_board_scores", scores);
+
+    if (!get_backend()->get_marginals(board, scores)) {
+        free(scores);
+        return NULL;
+    }
+    return scores;
+}
+
+/* Clears illegal values created along the way from the probabilities so they won't
+ * be considered */
+void clear_illegal_probabilities(Board *board, double *guesses, int i, int j) {
+    int v;
+    ValueSet candidates;
+    get_cell_candidates(board, &candidates, i, j);
+
+    for (v = 0; v < board->dim; v++) {
+        if (!contains_value(&candidates, v+1)) {
+            guesses[v] = 0.0;
+        }
+    }
+}
 
 bool guess_solution(Board *board, States *states, double threshold) {
-    return gurobi_solver(board, states, continuous, solve_board, NULL, threshold);
+    int i, j, value, dim = board->dim;
+    double *scores, *guesses;
+
+    scores = get_board_scores(board);
+    if (scores == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < dim; i++) {
+        for (j = 0; j < dim; j++) {
+            if (!is_cell_empty(board, i, j)) {
+                continue;
+            }
+
+            guesses = &scores[(i * dim + j) * dim];
+            clear_illegal_probabilities(board, guesses, i, j);
+            value = weighted_random_choice_with_threshold(guesses, dim, threshold);
+            if (value == ERROR_VALUE) {
+                continue;
+            }
+            make_change(board, states, i, j, value+1);
+        }
+    }
+    free(scores);
+    return true;
 }
 
 double* get_cell_guesses(Board *board, int row, int column) {
-    double *guesses;
-    SolutionData *data = malloc(sizeof(SolutionData));
-    validate_memory_allocation("get_cell_guesses", data);
+    int v, dim = board->dim;
+    double *guesses, *scores = get_board_scores(board);
 
-    data->row = row;
-    data->column = column;
-    data->guesses = NULL;
-
-    if (!gurobi_solver(board, NULL, continuous, cell_hint, data, 1.0)) {
-        free(data);
+    if (scores == NULL) {
         return NULL;
     }
-    guesses = data->guesses;
-    free(data);
+
+    guesses = malloc(dim * sizeof(double));
+    validate_memory_allocation("get_cell_guesses", guesses);
+    for (v = 0; v < dim; v++) {
+        guesses[v] = scores[(row * dim + column) * dim + v];
+    }
+    free(scores);
     return guesses;
 }
-
@@ -5,8 +5,10 @@
 #include "../components/StatesList.h"
 
 /**
- * Guesses a solution for the given board using LP (not ILP!), and fills the
- * board so that only guesses over the threshold are considered.
+ * Guesses a solution for the given board from the scores of the selected
+ * backend (see get_marginals in backend.h, e.g. LP - not ILP! - with the
+ * gurobi backend), and fills the board so that only guesses over the
+ * threshold are considered.
  *
  * Note: if more than one possible value is found, randomly chooses a value,
  *       using the scores as weights for the random choice.
@@ -25,7 +27,8 @@ bool guess_solution(Board *board, States *states, double threshold);
  * @param board: the board to guess a solution for.
  * @param row: the index of the cell's row (zero-based).
  * @param column: the index of the cell's column (zero-based).
- * @return: array of scores for the possible values.
+ * @return: array of scores for the possible values, or NULL if no scores were
+ * found (e.g. the board is unsolvable).
  */
 double* get_cell_guesses(Board *board, int row, int column);
 
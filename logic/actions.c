@@ -4,6 +4,7 @@
 #include "../io/Serializer.h"
 #include "../io/Printer.h"
 #include "backtracking.h"
+#include "backend.h"
 #include "ILP.h"
 #include "LP.h"
 #include "../MemoryError.h"
@@ -18,6 +19,9 @@
 #define MAX_TRIALS_REACHED "Error: The maximum number of attempts to generate a " \
                           "puzzle has been reached. Could not generate puzzle."
 
+/* The environment variable that enables reporting the size of the search. */
+#define STATS_ENV_VAR "SUDOKU_STATS"
+
 #define DEFAULT_SIZE (3)
 #define UNUSED(x) (void)(x)
 
@@ -90,6 +94,7 @@ void play_validate(Command *command, Game *game) {
 
     if (is_board_solvable(game->board)) {
         announce_game_solvable();
+        announce_solution_uniqueness(get_backend()->is_unique(game->board));
     } else {
         announce_game_not_solvable();
     }
@@ -208,9 +213,21 @@ void play_guess_hint(Command *command, Game *game) {
 }
 
 void play_num_solutions(Command *command, Game *game) {
-    UNUSED(command);
+    uint64_t limit = NO_SOLUTIONS_LIMIT;
+    unsigned long num_of_nodes;
+    Count counter;
 
-    announce_num_of_solutions(get_num_of_solutions(game->board));
+    if (command->data.num_solutions != NULL && command->data.num_solutions->limited) {
+        limit = (uint64_t) command->data.num_solutions->max;
+    }
+
+    init_count(&counter);
+    get_backend()->count(game->board, limit, &counter, &num_of_nodes);
+    announce_num_of_solutions(&counter, limit != NO_SOLUTIONS_LIMIT && is_count_at_least(&counter, limit));
+    if (getenv(STATS_ENV_VAR) != NULL) {
+        announce_num_of_search_nodes(num_of_nodes);
+    }
+    free_count(&counter);
 }
 
 void play_autofill(Command *command, Game *game) {
@@ -218,8 +235,6 @@ void play_autofill(Command *command, Game *game) {
     bool changes = false;
 
     Board *copy = get_board_copy(game->board);
-    bool *marks = malloc(copy->dim * sizeof(bool));
-    validate_memory_allocation("play_autofill", marks);
 
     UNUSED(command);
     add_new_move(game->states);
@@ -230,7 +245,7 @@ void play_autofill(Command *command, Game *game) {
                 continue;
             }
 
-            value = get_obvious_value(copy, marks, i, j);
+            value = get_obvious_value(copy, i, j);
             if (value == ERROR_VALUE) {
                 continue;
             }
@@ -245,7 +260,6 @@ void play_autofill(Command *command, Game *game) {
         }
     }
     destroy_board(copy);
-    free(marks);
 
     if (!changes) {
         announce_no_changes_made();
@@ -280,6 +294,15 @@ void play_reset(Command *command, Game *game) {
     print(game);
 }
 
+void play_backend(Command *command, Game *game) {
+    UNUSED(game);
+
+    if (command->data.backend->name != NULL) {
+        set_backend(command->data.backend->name);
+    }
+    announce_backend(get_backend()->name, get_backend_names());
+}
+
 void play_exit_game(Command *command, Game *game) {
     UNUSED(command);
 
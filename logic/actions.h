@@ -155,6 +155,15 @@ void play_autofill(Command *command, Game *game);
  */
 void play_reset(Command *command, Game *game);
 
+/**
+ * Plays the turn of a backend command based on the command's arguments: selects
+ * the given solver backend (if a name was given), and tells the user which
+ * backend is in use.
+ * @param command: the command to be executed.
+ * @param game: the current game.
+ */
+void play_backend(Command *command, Game *game);
+
 /**
  * Plays the turn of a exit_game command based on the command's arguments.
  * If a command execution fails, it invalidates the command with an appropriate
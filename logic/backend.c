@@ -0,0 +1,144 @@
+#include <stdlib.h>
+#include <string.h>
+#include "backend.h"
+#include "native.h"
+#include "backtracking.h"
+#include "dlx.h"
+#include "sat.h"
+#include "simplex.h"
+#include "sinkhorn.h"
+#include "sampling.h"
+#include "ILP.h"
+#ifdef USE_GUROBI
+#include "solver.h"
+#endif
+
+/* The environment variable that selects the backend at startup. */
+#define BACKEND_ENV_VAR "SUDOKU_BACKEND"
+
+#ifdef USE_GUROBI
+#define BACKEND_NAMES "native, dlx, sat, simplex, sinkhorn, sampling, gurobi"
+#else
+#define BACKEND_NAMES "native, dlx, sat, simplex, sinkhorn, sampling"
+#endif
+
+
+/* The default implementations of the operations that are derived from solve */
+
+/* Checks if the board is solvable by solving a copy of it. */
+bool is_solvable_by_solving(const Board *board) {
+    Board *copy = get_board_copy(board);
+    bool solvable = get_backend()->solve(copy);
+
+    destroy_board(copy);
+    return solvable;
+}
+
+/* Gets the solution of a cell by solving a copy of the board. */
+int get_cell_solution_by_solving(const Board *board, int row, int column) {
+    Board *copy = get_board_copy(board);
+    int cell_solution = ERROR_VALUE;
+
+    if (get_backend()->solve(copy)) {
+        cell_solution = get_cell_value(copy, row, column);
+    }
+    destroy_board(copy);
+    return cell_solution;
+}
+
+
+/* The registered backends (native is first, and implements every operation) */
+static const SolverBackend backends[] = {
+    {"native", find_solution, is_solvable_by_solving, get_cell_solution_by_solving,
+            get_simplex_marginals, get_num_of_solutions, is_unique},
+    {"dlx", NULL, NULL, NULL, NULL, get_num_of_solutions_dlx, NULL},
+    {"sat", find_sat_solution, NULL, NULL, NULL, count_sat_solutions, is_unique_sat},
+    {"simplex", NULL, NULL, NULL, get_simplex_marginals, NULL, NULL},
+    {"sinkhorn", NULL, NULL, NULL, get_sinkhorn_marginals, NULL, NULL},
+    {"sampling", NULL, NULL, NULL, get_sampled_marginals, NULL, NULL},
+#ifdef USE_GUROBI
+    {"gurobi", gurobi_solve, NULL, NULL, gurobi_get_marginals, NULL, NULL},
+#endif
+};
+
+#define NUM_OF_BACKENDS (sizeof(backends) / sizeof(backends[0]))
+
+/* The selected backend, with the missing operations filled in */
+static SolverBackend selected_backend;
+static bool backend_selected = false;
+
+
+/* Finds the registered backend with the given name (NULL if there is none). */
+const SolverBackend* find_backend(const char *name) {
+    size_t i;
+
+    for (i = 0; i < NUM_OF_BACKENDS; i++) {
+        if (strcmp(backends[i].name, name) == 0) {
+            return &backends[i];
+        }
+    }
+    return NULL;
+}
+
+/* Selects the given backend, and fills its missing operations from the
+ * native backend. */
+void select_backend(const SolverBackend *backend) {
+    const SolverBackend *default_backend = &backends[0];
+
+    selected_backend = *backend;
+    if (selected_backend.solve == NULL) {
+        selected_backend.solve = default_backend->solve;
+    }
+    if (selected_backend.is_solvable == NULL) {
+        selected_backend.is_solvable = default_backend->is_solvable;
+    }
+    if (selected_backend.get_cell_solution == NULL) {
+        selected_backend.get_cell_solution = default_backend->get_cell_solution;
+    }
+    if (selected_backend.get_marginals == NULL) {
+        selected_backend.get_marginals = default_backend->get_marginals;
+    }
+    if (selected_backend.count == NULL) {
+        selected_backend.count = default_backend->count;
+    }
+    if (selected_backend.is_unique == NULL) {
+        selected_backend.is_unique = default_backend->is_unique;
+    }
+    backend_selected = true;
+}
+
+const SolverBackend* get_backend() {
+    const char *name;
+
+    if (!backend_selected) {
+        name = getenv(BACKEND_ENV_VAR);
+        if (name == NULL || !set_backend(name)) {
+            set_backend(DEFAULT_BACKEND);
+        }
+    }
+    return &selected_backend;
+}
+
+bool set_backend(const char *name) {
+    const SolverBackend *backend = find_backend(name);
+
+    if (backend == NULL) {
+        return false;
+    }
+    select_backend(backend);
+    return true;
+}
+
+bool is_backend_available(const char *name) {
+    return find_backend(name) != NULL;
+}
+
+const char* get_backend_names() {
+    return BACKEND_NAMES;
+}
+
+void release_backends() {
+#ifdef USE_GUROBI
+    release_gurobi_resources();
+#endif
+}
@@ -0,0 +1,107 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include "../components/Board.h"
+#include "../components/Count.h"
+
+#ifndef FINAL_PROJECT_BACKEND_H
+#define FINAL_PROJECT_BACKEND_H
+
+/** backend:
+ *
+ *  The solver backends are the engines behind the solving commands (validate,
+ *  generate, hint, guess, guess_hint, num_solutions and save). Each backend is
+ *  a table of the operations it implements. An operation it leaves NULL is
+ *  done by the native backend instead. For is_solvable and
+ *  get_cell_solution, the default solves a copy of the board with the
+ *  selected backend's solve.
+ *  The backend in use is selected by name, either with the backend command or
+ *  with the SUDOKU_BACKEND environment variable (read on first use). The
+ *  available backends are:
+ *   - native: the built-in exact solver (see native.h). It counts with the
+ *     backtracking counter, and its marginals are the LP ones of the simplex
+ *     backend (a single solution would make every guess the same).
+ *   - dlx: counts solutions with Dancing Links (see dlx.h).
+ *   - sat: solves with the in-tree CDCL SAT solver, and counts up to a limit
+ *     (and checks uniqueness) by excluding each solution found (see sat.h).
+ *   - simplex: computes the marginals with LP, using the in-tree simplex
+ *     solver (see simplex.h).
+ *   - sinkhorn: estimates the marginals by Sinkhorn balancing, a fast
+ *     approximation of the LP (see sinkhorn.h).
+ *   - sampling: estimates the marginals from the value frequencies of random
+ *     solutions, drawn in parallel (see sampling.h).
+ *   - gurobi: solves with ILP and computes the marginals with LP, using
+ *     Gurobi (see solver.h). Only available if built with USE_GUROBI.
+ */
+
+/* The name of the backend used when none was selected: gurobi if it's built
+ * in (as before there were backends), and native otherwise. */
+#ifdef USE_GUROBI
+#define DEFAULT_BACKEND "gurobi"
+#else
+#define DEFAULT_BACKEND "native"
+#endif
+
+typedef struct {
+    const char *name;
+
+    /* Fills the empty cells of the board with a solution. Returns false if
+     * there is none, in which case the board is left unchanged. */
+    bool (*solve)(Board *board);
+
+    /* Returns true if the board has a solution. */
+    bool (*is_solvable)(const Board *board);
+
+    /* Returns the value of the cell in a solution of the board, or ERROR_VALUE
+     * (see ILP.h) if there is none. */
+    int (*get_cell_solution)(const Board *board, int row, int column);
+
+    /* Fills scores with a score in [0, 1] for each empty cell and value, the
+     * confidence that the cell holds the value in a solution (0 for values
+     * that aren't legal in the cell). The score of value v (1-based) at the
+     * cell (row, column) is at scores[(row * dim + column) * dim + v - 1].
+     * Returns false if no scores were found. */
+    bool (*get_marginals)(const Board *board, double *scores);
+
+    /* Counts the solutions of a board that isn't erroneous (see
+     * get_num_of_solutions in backtracking.h). */
+    void (*count)(const Board *board, uint64_t limit, Count *counter, unsigned long *num_of_nodes);
+
+    /* Returns true if the board has exactly one solution. */
+    bool (*is_unique)(const Board *board);
+} SolverBackend;
+
+/**
+ * Returns the selected backend, where every operation is set (the operations
+ * the backend doesn't implement are filled from the native backend).
+ * @return: the backend to solve with.
+ */
+const SolverBackend* get_backend();
+
+/**
+ * Selects the backend to solve with.
+ * @param name: the name of the backend.
+ * @return: true if the backend was selected, and false if there is no
+ * backend with the given name (the selection is then unchanged).
+ */
+bool set_backend(const char *name);
+
+/**
+ * Checks if a backend with the given name is available.
+ * @param name: the name to check.
+ * @return: true if there is a backend with that name, and false otherwise.
+ */
+bool is_backend_available(const char *name);
+
+/**
+ * Returns the names of the available backends, separated by commas.
+ * @return: a constant string of the names.
+ */
+const char* get_backend_names();
+
+/**
+ * Releases the resources the backends keep between calls (e.g. the gurobi
+ * environment). To be used once, before the process exits.
+ */
+void release_backends();
+
+#endif
@@ -1,95 +1,188 @@
+#include <stdlib.h>
 #include "backtracking.h"
 #include "../components/Stack.h"
-#include "ILP.h"
+#include "../MemoryError.h"
+#include "parallel.h"
 
 
-void backtrack_to_stack_top(Stack *stack, int *row, int *column, int *val){
+void backtrack_to_stack_top(Board *board, Stack *stack, int *row, int *column, int *val){
     StackNode* top_node = pop(stack);
     *row = top_node->row;
     *column = top_node->column;
     *val = top_node->val;
-    destroy_stack_node(top_node);
+    pop_level(board); /* undo the assignment of the popped cell */
 }
 
-void update_next_cell_coordinates(int *row, int *column, int N){
-    if (*column == N-1){ /* The rightmost cell in the row */
-        *row = *row + 1;
-        *column = 0;
+int get_branch_values(const Board *board, ValueSet *values, int row, int column, int *symmetric_value) {
+    ValueSet used, unused_candidates;
+    unsigned int i;
+    int multiplicity;
+
+    get_cell_candidates(board, values, row, column);
+    get_used_values(board, &used);
+
+    /* the candidates that no cell uses yet can be relabeled into each other,
+     * so their subtrees have the same number of solutions */
+    for (i = 0; i < VALUE_SET_WORDS; i++) {
+        unused_candidates.words[i] = values->words[i] & ~used.words[i];
+        values->words[i] &= used.words[i];
     }
-    else { /* column < N-1 */
-        *column = *column + 1; /* and row is not changing */
+
+    multiplicity = count_values(&unused_candidates);
+    *symmetric_value = get_next_value(&unused_candidates, CLEAR);
+    if (*symmetric_value != CLEAR) {
+        add_value(values, *symmetric_value);
     }
+    return multiplicity;
 }
 
-int get_num_of_solutions(const Board *board) {
-    int counter = 0, row = 0, column = 0, val = CLEAR, N = board->dim;
-    bool backtrack = false;
-    Board *board_copy;
-    Stack *stack;
+/* Checks if the counter has reached the limit (if there is one). */
+bool is_limit_reached(const Count *counter, uint64_t limit) {
+    return limit != NO_SOLUTIONS_LIMIT && is_count_at_least(counter, limit);
+}
 
-    if (N == 1) {
-        return 1; /*if the board is 1x1 there is 1 solution*/
+bool expand_node(Search *search, const Count *weight, Count *counter) {
+    int count;
+
+    if (!propagate(search)) {
+        return false;
+    }
+    if (search->depth == search->num_of_empty) {
+        add_count(counter, weight);
+        return false;
     }
 
-    if (!is_board_solvable(board)) { /* The board is unsolvable (using ILP) */
-        return 0;
+    count = select_most_constrained_cell(search);
+    if (search->depth == search->num_of_empty - 1) {
+        /* each candidate of the last cell is a solution */
+        add_count_product(counter, weight, count);
+        return false;
     }
+    return count > 0;
+}
 
-    stack = create_stack();
-    board_copy = get_board_copy(board);
-    fix_non_empty_board_cells(board_copy);
-
-    while (1) {
-        if (is_cell_fixed(board_copy, row, column)) {
-            if (row == N - 1 && column == N - 1) { /* if last cell - increment the counter and then backtrack */
-                counter++;
-                if (is_stack_empty(stack)) {
-                    break; /* can't backtrack  */
-                }
-                backtrack_to_stack_top(stack, &row, &column, &val);
-                continue;
-            }
+void count_completions(Search *search, Stack *stack, const Count *weight, uint64_t limit, Count *counter) {
+    int i, row, column, val = CLEAR, cell, level, symmetric_value, multiplicity;
+    int first = search->depth, num_of_levels = search->num_of_empty - search->depth + 1, N = search->board->dim;
+    Board *board = search->board;
+    Count *weights;
+    ValueSet values;
 
-            update_next_cell_coordinates(&row, &column, N);
-            continue;
-        } else {
-            do {
-                val++;
-                if (val > N) {
-                    backtrack = true; /* No legal values for the cell, need to backtrack*/
-                    break;
-                }
-                set_cell_value(board_copy, row, column, val);
-            } while (is_cell_erroneous(board_copy, row, column));
+    /* weights[level] is the number of solutions that each solution found
+     * below the decision at that level stands for */
+    weights = malloc(num_of_levels * sizeof(Count));
+    validate_memory_allocation("count_completions", weights);
+    for (i = 0; i < num_of_levels; i++) {
+        init_count(&weights[i]);
+    }
+    set_count(&weights[0], weight);
 
-            if (backtrack) {
-                if (is_stack_empty(stack)) {
-                    break; /* can't backtrack  */
+    push_level(board); /* the root level, for the cells propagated before any decision */
+    if (expand_node(search, weight, counter)) {
+        /* empty_cells[depth] is always the cell that's being decided, the cells
+         * before it are assigned, and the cells after it are still empty */
+        while (1) {
+            cell = search->empty_cells[search->depth];
+            row = cell / N;
+            column = cell % N;
+            multiplicity = get_branch_values(board, &values, row, column, &symmetric_value);
+            val = get_next_value(&values, val);
+
+            if (val != CLEAR) {
+                level = stack->size;
+                set_count(&weights[level + 1], &weights[level]);
+                if (val == symmetric_value) {
+                    multiply_count(&weights[level + 1], multiplicity);
                 }
-                set_cell_value(board_copy, row, column, CLEAR); /* clear the cell */
-                backtrack = false;
-                backtrack_to_stack_top(stack, &row, &column, &val);
-                continue;
-            }
+                push_level(board);
+                assign_cell(search, cell, val);
+                push(row, column, val, stack);
+                search->num_of_nodes++;
+                val = CLEAR;
 
-            if (row == N - 1 && column == N - 1) { /* if last cell - increment the counter and then backtrack */
-                counter++;
-                set_cell_value(board_copy, row, column, CLEAR); /* clear the cell */
-                if (is_stack_empty(stack)) {
-                    break; /* can't backtrack  */
+                if (expand_node(search, &weights[level + 1], counter)) {
+                    continue; /* go deeper */
                 }
-                backtrack_to_stack_top(stack, &row, &column, &val);
-                continue;
+                /* a solution or a dead end: fall through to try the next value */
             }
 
-            push(row, column, val, stack);
-            update_next_cell_coordinates(&row, &column, N);
-            val = CLEAR;
-            continue;
+            if (is_limit_reached(counter, limit)) {
+                break;
+            }
+            if (is_stack_empty(stack)) {
+                break; /* can't backtrack  */
+            }
+            backtrack_to_stack_top(board, stack, &row, &column, &val);
+            search->depth = search->positions[row * N + column]; /* the decided cell stays in place */
         }
     }
 
+    /* undo the remaining decisions (if the search was stopped early), and the
+     * root propagation */
+    while (!is_stack_empty(stack)) {
+        backtrack_to_stack_top(board, stack, &row, &column, &val);
+    }
+    pop_level(board);
+    search->depth = first;
+
+    for (i = 0; i < num_of_levels; i++) {
+        free_count(&weights[i]);
+    }
+    free(weights);
+}
+
+void get_num_of_solutions(const Board *board, uint64_t limit, Count *counter, unsigned long *num_of_nodes) {
+    int num_of_threads;
+    Board *board_copy;
+    Search *search;
+    Stack *stack;
+    Count weight;
+
+    set_count_value(counter, 0);
+    if (num_of_nodes != NULL) {
+        *num_of_nodes = 0;
+    }
+
+    /* an erroneous board can't be completed. Other dead ends are found by
+     * the search's propagation */
+    if (is_board_erroneous(board)) {
+        return;
+    }
+
+    board_copy = get_board_copy(board);
+    search = create_search(board_copy);
+
+    /* a limited count is expected to stop early, not worth splitting */
+    num_of_threads = (limit == NO_SOLUTIONS_LIMIT) ? get_num_of_threads() : 1;
+    if (num_of_threads > 1) {
+        count_completions_in_parallel(search, num_of_threads, counter);
+    } else {
+        init_count(&weight);
+        set_count_value(&weight, 1);
+        stack = create_stack(search->num_of_empty);
+        count_completions(search, stack, &weight, limit, counter);
+        destroy_stack(stack);
+        free_count(&weight);
+    }
+
+    if (is_limit_reached(counter, limit)) {
+        set_count_value(counter, limit);
+    }
+    if (num_of_nodes != NULL) {
+        *num_of_nodes = search->num_of_nodes;
+    }
+
+    destroy_search(search);
     destroy_board(board_copy);
-    destroy_stack(stack);
-    return counter;
-}
\ No newline at end of file
+}
+
+bool is_unique(const Board *board) {
+    Count counter;
+    bool unique;
+
+    init_count(&counter);
+    get_num_of_solutions(board, 2, &counter, NULL);
+    unique = !is_count_at_least(&counter, 2) && is_count_at_least(&counter, 1);
+    free_count(&counter);
+    return unique;
+}
@@ -1,35 +1,91 @@
-#include "../components/Board.h"
-#include "../components/Stack.h"
-
 #ifndef FINAL_PROJECT_BACKTRACKING_H
 #define FINAL_PROJECT_BACKTRACKING_H
 
-#endif
+#include "../components/Board.h"
+#include "../components/Stack.h"
+#include "../components/Count.h"
+#include "search.h"
+
+/* The limit to pass for counting all the solutions. */
+#define NO_SOLUTIONS_LIMIT (0)
 
 /**
- * Removes the top from the stack and updates row, column and val accordingly
+ * Removes the top from the stack and updates row, column and val accordingly.
+ * Also undoes the assignment of the removed cell on the board (pops the
+ * board's trail level that was opened for it).
+ * @param board: the board that is being searched.
  * @param stack: the stack to remove the top from.
  * @param row: pointer to the row current value, to be updated.
  * @param column: pointer to the column current value, to be updated.
  * @param val: pointer to the val current value, to be updated.
  */
-void backtrack_to_stack_top(Stack *stack, int *row, int *column, int *val);
+void backtrack_to_stack_top(Board *board, Stack *stack, int *row, int *column, int *val);
 
 /**
- * Updates row and column according to the next cell coordinates (assuming that
- * (row, column) is not the last cell).
- * @param row: pointer to the row current value, to be updated.
- * @param column: pointer to the column current value, to be updated.
- * @param N: the board dimension.
+ * Fills values with the values to branch on at the cell at the given
+ * coordinates: its candidates, where all the candidates that aren't used by
+ * any cell of the board are replaced by the smallest of them. Values no cell
+ * uses are interchangeable (relabeling them maps solutions to solutions), so
+ * the subtree of that single value stands for all of them.
+ * @param board: the board that is being searched.
+ * @param values: the set to be filled with the values to branch on.
+ * @param row: the index of the cell's row (zero-based).
+ * @param column: the index of the cell's column (zero-based).
+ * @param symmetric_value: pointer to be updated with the value that stands for
+ * the unused candidates (CLEAR if there are none).
+ * @return: the number of unused candidates (the weight of symmetric_value).
  */
-void update_next_cell_coordinates(int *row, int *column, int N);
+int get_branch_values(const Board *board, ValueSet *values, int row, int column, int *symmetric_value);
 
 /**
- * Returns the number of solutions of the board, and -1 if there is no solution
- * (meaning the board is unsolvable).
+ * Propagates the constraints at the current node of the search, and selects
+ * the cell to branch on. If the node's solutions are known without branching
+ * (the board is full, or a single cell is left), adds them (multiplied by the
+ * given weight) to the counter instead.
+ * @param search: the search to update.
+ * @param weight: the number of solutions each completion of the node stands for.
+ * @param counter: the count to add the solutions to.
+ * @return: true if the search should branch on the selected cell
+ * (empty_cells[depth]), and false otherwise (solved or a dead end).
+ */
+bool expand_node(Search *search, const Count *weight, Count *counter);
+
+/**
+ * Counts the ways to complete the board of the search (its solutions), and
+ * adds them (multiplied by the given weight) to the counter, until the
+ * counter reaches the limit. At each node, the constraints are propagated,
+ * and then the search branches on the most constrained empty cell. The board
+ * is back in its original state when the function returns.
+ * @param search: the search to run, from its current depth. Its board must
+ * not be erroneous.
+ * @param stack: an empty stack to use for the search (left empty).
+ * @param weight: the number of solutions each completion stands for.
+ * @param limit: the count to stop the search at, or NO_SOLUTIONS_LIMIT.
+ * @param counter: the count to add the solutions to.
+ */
+void count_completions(Search *search, Stack *stack, const Count *weight, uint64_t limit, Count *counter);
+
+/**
+ * Counts the solutions of the board, using an exhaustive search that
+ * propagates the constraints at each node, always branches on the most
+ * constrained empty cell, and counts the subtrees of interchangeable values
+ * once. The search is split between multiple threads when more than one is
+ * available (see get_num_of_threads) and the count isn't limited.
  * @param board: the board to get the number of solutions for.
- * @return: the number of solutions for the given board.
+ * @param limit: the number of solutions to stop the search at (the counter is
+ * then set to the limit), or NO_SOLUTIONS_LIMIT to count all of them.
+ * @param counter: an initialized count, set to the number of solutions.
+ * @param num_of_nodes: pointer to be updated with the number of decisions the
+ * search made (may be NULL).
  */
-int get_num_of_solutions(const Board *board);
+void get_num_of_solutions(const Board *board, uint64_t limit, Count *counter, unsigned long *num_of_nodes);
 
+/**
+ * Checks if the board has exactly one solution. Stops searching as soon as a
+ * second solution is found. The is_unique operation of the native backend.
+ * @param board: the board to check.
+ * @return: true if the board has a single solution, and false otherwise.
+ */
+bool is_unique(const Board *board);
 
+#endif
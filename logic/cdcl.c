@@ -0,0 +1,721 @@
+#include <stdlib.h>
+#include "cdcl.h"
+#include "../MemoryError.h"
+
+/* The values of variables and literals */
+#define VALUE_FALSE (0)
+#define VALUE_TRUE (1)
+#define UNASSIGNED (-1)
+
+#define NO_CLAUSE (-1)
+#define NOT_IN_HEAP (-1)
+
+/* Binary clauses are marked in the watch lists (by a negative reference), so
+ * they're propagated from the blocker alone, without reading the clause */
+#define BINARY_WATCH(clause) (-(clause) - 1)
+#define IS_BINARY_WATCH(watch) ((watch) < 0)
+
+/* The clause layout in the arena */
+#define CLAUSE_SIZE(solver, clause) ((solver)->_arena[clause])
+#define CLAUSE_HEADER(solver, clause) ((solver)->_arena[(clause) + 1])
+#define CLAUSE_LITERALS(solver, clause) (&(solver)->_arena[(clause) + 2])
+#define CLAUSE_OVERHEAD (2)
+#define LEARNT_FLAG (1)
+#define DELETED_FLAG (2)
+#define LBD_SHIFT (2)
+
+#define INITIAL_CAPACITY (64)
+#define ACTIVITY_DECAY (0.95)
+#define ACTIVITY_LIMIT (1e100)
+#define RESTART_UNIT (100)          /* the number of conflicts in a unit of the Luby sequence */
+#define MIN_MAX_LEARNTS (2000)
+#define LEARNTS_GROWTH (1.1)
+#define GLUE_LBD (2)                /* learnt clauses of at most this LBD are always kept */
+
+/* The outcomes of a search between restarts */
+typedef enum {
+    sat_satisfiable,
+    sat_unsatisfiable,
+    sat_restart
+} SearchStatus;
+
+
+/* Grows the given array (of elements of the given size) to the new capacity */
+void* grow_sat_array(void *array, int capacity, size_t element_size) {
+    array = realloc(array, capacity * element_size);
+    validate_memory_allocation("grow_sat_array", array);
+    return array;
+}
+
+SatSolver* create_sat_solver() {
+    SatSolver *solver = calloc(1, sizeof(SatSolver));
+    validate_memory_allocation("create_sat_solver", solver);
+
+    solver->_activity_increment = 1.0;
+    solver->_max_learnts = MIN_MAX_LEARNTS;
+    solver->_trail_limits = grow_sat_array(NULL, 1, sizeof(int));
+    solver->_level_stamps = grow_sat_array(NULL, 1, sizeof(int));
+    solver->_level_stamps[0] = 0;
+    return solver;
+}
+
+void destroy_sat_solver(SatSolver *solver) {
+    int literal;
+
+    for (literal = 0; literal < 2 * solver->num_of_vars; literal++) {
+        free(solver->_watches[literal].items);
+    }
+    free(solver->_watches);
+    free(solver->_arena);
+    free(solver->_clauses);
+    free(solver->_learnts);
+    free(solver->_values);
+    free(solver->_levels);
+    free(solver->_reasons);
+    free(solver->_activities);
+    free(solver->_phases);
+    free(solver->_seen);
+    free(solver->_heap);
+    free(solver->_heap_positions);
+    free(solver->_decisions);
+    free(solver->_trail);
+    free(solver->_trail_limits);
+    free(solver->_learnt);
+    free(solver->_level_stamps);
+    free(solver->model);
+    free(solver);
+}
+
+
+/* The activity heap of the unassigned variables */
+
+/* Moves the variable at the given heap position up, to its place. */
+void sift_heap_up(SatSolver *solver, int position) {
+    int var = solver->_heap[position], parent;
+
+    while (position > 0) {
+        parent = (position - 1) / 2;
+        if (solver->_activities[solver->_heap[parent]] >= solver->_activities[var]) {
+            break;
+        }
+        solver->_heap[position] = solver->_heap[parent];
+        solver->_heap_positions[solver->_heap[position]] = position;
+        position = parent;
+    }
+    solver->_heap[position] = var;
+    solver->_heap_positions[var] = position;
+}
+
+/* Moves the variable at the given heap position down, to its place. */
+void sift_heap_down(SatSolver *solver, int position) {
+    int var = solver->_heap[position], child;
+
+    for (;;) {
+        child = 2 * position + 1;
+        if (child >= solver->_heap_size) {
+            break;
+        }
+        if (child + 1 < solver->_heap_size &&
+            solver->_activities[solver->_heap[child + 1]] > solver->_activities[solver->_heap[child]]) {
+            child++;
+        }
+        if (solver->_activities[solver->_heap[child]] <= solver->_activities[var]) {
+            break;
+        }
+        solver->_heap[position] = solver->_heap[child];
+        solver->_heap_positions[solver->_heap[position]] = position;
+        position = child;
+    }
+    solver->_heap[position] = var;
+    solver->_heap_positions[var] = position;
+}
+
+void insert_heap_var(SatSolver *solver, int var) {
+    if (!solver->_decisions[var] || solver->_heap_positions[var] != NOT_IN_HEAP) {
+        return;
+    }
+    solver->_heap[solver->_heap_size] = var;
+    solver->_heap_positions[var] = solver->_heap_size;
+    solver->_heap_size++;
+    sift_heap_up(solver, solver->_heap_size - 1);
+}
+
+int remove_heap_max(SatSolver *solver) {
+    int var = solver->_heap[0];
+
+    solver->_heap_size--;
+    solver->_heap_positions[var] = NOT_IN_HEAP;
+    if (solver->_heap_size > 0) {
+        solver->_heap[0] = solver->_heap[solver->_heap_size];
+        solver->_heap_positions[solver->_heap[0]] = 0;
+        sift_heap_down(solver, 0);
+    }
+    return var;
+}
+
+/* Increases the activity of the variable (it took part in a conflict). */
+void bump_var_activity(SatSolver *solver, int var) {
+    int i;
+
+    solver->_activities[var] += solver->_activity_increment;
+    if (solver->_activities[var] > ACTIVITY_LIMIT) {
+        /* rescale all the activities, keeping their order */
+        for (i = 0; i < solver->num_of_vars; i++) {
+            solver->_activities[i] /= ACTIVITY_LIMIT;
+        }
+        solver->_activity_increment /= ACTIVITY_LIMIT;
+    }
+    if (solver->_heap_positions[var] != NOT_IN_HEAP) {
+        sift_heap_up(solver, solver->_heap_positions[var]);
+    }
+}
+
+
+/* Variables, clauses and watches */
+
+int add_sat_variable(SatSolver *solver, bool is_decision) {
+    int var = solver->num_of_vars, capacity;
+
+    if (var == solver->vars_capacity) {
+        capacity = (var == 0) ? INITIAL_CAPACITY : 2 * var;
+        solver->_watches = grow_sat_array(solver->_watches, 2 * capacity, sizeof(WatchList));
+        solver->_values = grow_sat_array(solver->_values, capacity, sizeof(signed char));
+        solver->_levels = grow_sat_array(solver->_levels, capacity, sizeof(int));
+        solver->_reasons = grow_sat_array(solver->_reasons, capacity, sizeof(int));
+        solver->_activities = grow_sat_array(solver->_activities, capacity, sizeof(double));
+        solver->_phases = grow_sat_array(solver->_phases, capacity, sizeof(signed char));
+        solver->_seen = grow_sat_array(solver->_seen, capacity, sizeof(signed char));
+        solver->_heap = grow_sat_array(solver->_heap, capacity, sizeof(int));
+        solver->_heap_positions = grow_sat_array(solver->_heap_positions, capacity, sizeof(int));
+        solver->_decisions = grow_sat_array(solver->_decisions, capacity, sizeof(bool));
+        solver->_trail = grow_sat_array(solver->_trail, capacity, sizeof(int));
+        solver->_trail_limits = grow_sat_array(solver->_trail_limits, capacity + 1, sizeof(int));
+        solver->_learnt = grow_sat_array(solver->_learnt, capacity, sizeof(int));
+        solver->_level_stamps = grow_sat_array(solver->_level_stamps, capacity + 1, sizeof(int));
+        solver->model = grow_sat_array(solver->model, capacity, sizeof(signed char));
+        solver->vars_capacity = capacity;
+    }
+
+    solver->num_of_vars++;
+    solver->_watches[POSITIVE_LITERAL(var)].items = NULL;
+    solver->_watches[POSITIVE_LITERAL(var)].size = 0;
+    solver->_watches[POSITIVE_LITERAL(var)].capacity = 0;
+    solver->_watches[NEGATIVE_LITERAL(var)] = solver->_watches[POSITIVE_LITERAL(var)];
+    solver->_values[var] = UNASSIGNED;
+    solver->_levels[var] = 0;
+    solver->_reasons[var] = NO_CLAUSE;
+    solver->_activities[var] = 0.0;
+    solver->_phases[var] = is_decision ? VALUE_TRUE : VALUE_FALSE;
+    solver->_decisions[var] = is_decision;
+    solver->_seen[var] = false;
+    solver->_level_stamps[var + 1] = 0;
+    solver->model[var] = VALUE_FALSE;
+    solver->_heap_positions[var] = NOT_IN_HEAP;
+    insert_heap_var(solver, var);
+    return var;
+}
+
+/* Returns the value of the literal (VALUE_TRUE, VALUE_FALSE or UNASSIGNED). */
+int get_literal_value(const SatSolver *solver, int literal) {
+    int value = solver->_values[LITERAL_VAR(literal)];
+    return (value == UNASSIGNED) ? UNASSIGNED : value ^ (literal & 1);
+}
+
+/* Adds a (clause, blocker) pair to the watch list. */
+void add_watch(WatchList *watches, int clause, int blocker) {
+    if (watches->size + 2 > watches->capacity) {
+        watches->capacity = (watches->capacity == 0) ? 4 : 2 * watches->capacity;
+        watches->items = grow_sat_array(watches->items, watches->capacity, sizeof(int));
+    }
+    watches->items[watches->size] = clause;
+    watches->items[watches->size + 1] = blocker;
+    watches->size += 2;
+}
+
+/* Watches the first two literals of the clause. */
+void attach_clause(SatSolver *solver, int clause) {
+    int *literals = CLAUSE_LITERALS(solver, clause);
+    int watch = (CLAUSE_SIZE(solver, clause) == 2) ? BINARY_WATCH(clause) : clause;
+
+    add_watch(&solver->_watches[NEGATE_LITERAL(literals[0])], watch, literals[1]);
+    add_watch(&solver->_watches[NEGATE_LITERAL(literals[1])], watch, literals[0]);
+}
+
+/* Copies a clause to the arena, and returns its reference. */
+int allocate_clause(SatSolver *solver, const int *literals, int size, int header) {
+    int i, clause = solver->_arena_size;
+
+    if (solver->_arena_size + size + CLAUSE_OVERHEAD > solver->_arena_capacity) {
+        solver->_arena_capacity = 2 * (solver->_arena_size + size + CLAUSE_OVERHEAD);
+        solver->_arena = grow_sat_array(solver->_arena, solver->_arena_capacity, sizeof(int));
+    }
+    CLAUSE_SIZE(solver, clause) = size;
+    CLAUSE_HEADER(solver, clause) = header;
+    for (i = 0; i < size; i++) {
+        CLAUSE_LITERALS(solver, clause)[i] = literals[i];
+    }
+    solver->_arena_size += size + CLAUSE_OVERHEAD;
+    return clause;
+}
+
+/* Appends a clause reference to a list of references. */
+void append_clause_reference(int **list, int *size, int *capacity, int clause) {
+    if (*size == *capacity) {
+        *capacity = (*capacity == 0) ? INITIAL_CAPACITY : 2 * (*capacity);
+        *list = grow_sat_array(*list, *capacity, sizeof(int));
+    }
+    (*list)[*size] = clause;
+    (*size)++;
+}
+
+
+/* Assignments */
+
+/* Makes the literal true, as implied by the given clause (or decided). */
+void assign_literal(SatSolver *solver, int literal, int reason) {
+    int var = LITERAL_VAR(literal);
+
+    solver->_values[var] = (literal & 1) ? VALUE_FALSE : VALUE_TRUE;
+    solver->_levels[var] = solver->_num_of_levels;
+    solver->_reasons[var] = reason;
+    solver->_trail[solver->_trail_size] = literal;
+    solver->_trail_size++;
+}
+
+/* Undoes the assignments of the levels above the given level. */
+void backtrack_sat(SatSolver *solver, int level) {
+    int i, var;
+
+    if (solver->_num_of_levels <= level) {
+        return;
+    }
+    for (i = solver->_trail_size - 1; i >= solver->_trail_limits[level]; i--) {
+        var = LITERAL_VAR(solver->_trail[i]);
+        solver->_phases[var] = solver->_values[var];
+        solver->_values[var] = UNASSIGNED;
+        solver->_reasons[var] = NO_CLAUSE;
+        insert_heap_var(solver, var);
+    }
+    solver->_trail_size = solver->_trail_limits[level];
+    solver->_propagated = solver->_trail_size;
+    solver->_num_of_levels = level;
+}
+
+/* Propagates the assigned literals through the clauses that watch them.
+ * Returns the clause that became false, or NO_CLAUSE if there's no conflict.
+ * The literal a clause implies isn't necessarily its first literal (binary
+ * clauses aren't reordered). */
+int propagate_sat(SatSolver *solver) {
+    int i, j, k, literal, false_literal, clause, blocker, first, size, *literals, conflict = NO_CLAUSE, value;
+    WatchList *watches;
+
+    while (solver->_propagated < solver->_trail_size && conflict == NO_CLAUSE) {
+        literal = solver->_trail[solver->_propagated];
+        solver->_propagated++;
+        false_literal = NEGATE_LITERAL(literal);
+        watches = &solver->_watches[literal];
+
+        for (i = 0, j = 0; i < watches->size; ) {
+            clause = watches->items[i];
+            blocker = watches->items[i + 1];
+            i += 2;
+            value = get_literal_value(solver, blocker);
+            if (value == VALUE_TRUE) {
+                watches->items[j++] = clause;
+                watches->items[j++] = blocker;
+                continue;
+            }
+            if (IS_BINARY_WATCH(clause)) {
+                watches->items[j++] = clause;
+                watches->items[j++] = blocker;
+                if (value == VALUE_FALSE) {
+                    conflict = BINARY_WATCH(clause);
+                    while (i < watches->size) {
+                        watches->items[j++] = watches->items[i++];
+                    }
+                } else {
+                    assign_literal(solver, blocker, BINARY_WATCH(clause));
+                }
+                continue;
+            }
+
+            /* keep the false literal second */
+            literals = CLAUSE_LITERALS(solver, clause);
+            size = CLAUSE_SIZE(solver, clause);
+            if (literals[0] == false_literal) {
+                literals[0] = literals[1];
+                literals[1] = false_literal;
+            }
+            first = literals[0];
+            if (first != blocker && get_literal_value(solver, first) == VALUE_TRUE) {
+                watches->items[j++] = clause;
+                watches->items[j++] = first;
+                continue;
+            }
+
+            /* look for another literal to watch */
+            for (k = 2; k < size; k++) {
+                if (get_literal_value(solver, literals[k]) != VALUE_FALSE) {
+                    literals[1] = literals[k];
+                    literals[k] = false_literal;
+                    add_watch(&solver->_watches[NEGATE_LITERAL(literals[1])], clause, first);
+                    break;
+                }
+            }
+            if (k < size) {
+                continue;
+            }
+
+            /* the clause is unit (first is implied) or false */
+            watches->items[j++] = clause;
+            watches->items[j++] = first;
+            if (get_literal_value(solver, first) == VALUE_FALSE) {
+                conflict = clause;
+                while (i < watches->size) {
+                    watches->items[j++] = watches->items[i++];
+                }
+            } else {
+                assign_literal(solver, first, clause);
+            }
+        }
+        watches->size = j;
+    }
+    return conflict;
+}
+
+bool add_sat_clause(SatSolver *solver, const int *literals, int size) {
+    int i, num_of_literals = 0, clause, value;
+
+    if (solver->unsatisfiable) {
+        return false;
+    }
+    backtrack_sat(solver, 0);
+
+    /* drop the false literals, and skip satisfied clauses */
+    for (i = 0; i < size; i++) {
+        value = get_literal_value(solver, literals[i]);
+        if (value == VALUE_TRUE) {
+            return true;
+        }
+        if (value == UNASSIGNED) {
+            solver->_learnt[num_of_literals] = literals[i];
+            num_of_literals++;
+        }
+    }
+
+    if (num_of_literals == 0) {
+        solver->unsatisfiable = true;
+    } else if (num_of_literals == 1) {
+        assign_literal(solver, solver->_learnt[0], NO_CLAUSE);
+        solver->unsatisfiable = (propagate_sat(solver) != NO_CLAUSE);
+    } else {
+        clause = allocate_clause(solver, solver->_learnt, num_of_literals, 0);
+        append_clause_reference(&solver->_clauses, &solver->_num_of_clauses, &solver->_clauses_capacity, clause);
+        attach_clause(solver, clause);
+    }
+    return !solver->unsatisfiable;
+}
+
+
+/* Conflict analysis */
+
+/* Checks if the literal of the learnt clause is implied by the others (all
+ * the other literals of its reason are in the clause or fixed at level 0). */
+bool is_literal_redundant(const SatSolver *solver, int literal) {
+    int i, var, reason = solver->_reasons[LITERAL_VAR(literal)];
+    const int *literals;
+
+    if (reason == NO_CLAUSE) {
+        return false;
+    }
+    literals = CLAUSE_LITERALS(solver, reason);
+    for (i = 0; i < CLAUSE_SIZE(solver, reason); i++) {
+        var = LITERAL_VAR(literals[i]);
+        if (var != LITERAL_VAR(literal) && !solver->_seen[var] && solver->_levels[var] > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Counts the distinct decision levels of the learnt clause (its LBD). */
+int count_clause_levels(SatSolver *solver, int size) {
+    int i, level, num_of_levels = 0;
+
+    solver->_stamp++;
+    for (i = 0; i < size; i++) {
+        level = solver->_levels[LITERAL_VAR(solver->_learnt[i])];
+        if (solver->_level_stamps[level] != solver->_stamp) {
+            solver->_level_stamps[level] = solver->_stamp;
+            num_of_levels++;
+        }
+    }
+    return num_of_levels;
+}
+
+/* Learns a clause from the conflict: the negation of the assignments that
+ * caused it, cut at the first unique implication point of the current level.
+ * The clause is built in the learnt buffer, with the literal of the current
+ * level first and a literal of the highest other level second. Returns its
+ * size, and updates level with the level to backtrack to. */
+int analyze_conflict(SatSolver *solver, int conflict, int *level) {
+    int i, j, var, literal = UNASSIGNED, size = 1, num_of_paths = 0, index = solver->_trail_size - 1;
+    int clause_size, *literals, max_position;
+
+    do {
+        literals = CLAUSE_LITERALS(solver, conflict);
+        clause_size = CLAUSE_SIZE(solver, conflict);
+        for (i = 0; i < clause_size; i++) {
+            var = LITERAL_VAR(literals[i]);
+            if (literals[i] == literal || solver->_seen[var] || solver->_levels[var] == 0) {
+                continue;
+            }
+            solver->_seen[var] = true;
+            bump_var_activity(solver, var);
+            if (solver->_levels[var] >= solver->_num_of_levels) {
+                num_of_paths++;
+            } else {
+                solver->_learnt[size] = literals[i];
+                size++;
+            }
+        }
+
+        /* the next seen literal of the trail */
+        while (!solver->_seen[LITERAL_VAR(solver->_trail[index])]) {
+            index--;
+        }
+        literal = solver->_trail[index];
+        index--;
+        conflict = solver->_reasons[LITERAL_VAR(literal)];
+        solver->_seen[LITERAL_VAR(literal)] = false;
+        num_of_paths--;
+    } while (num_of_paths > 0);
+    solver->_learnt[0] = NEGATE_LITERAL(literal);
+
+    /* drop the literals that are implied by the rest of the clause */
+    for (i = 1, j = 1; i < size; i++) {
+        if (!is_literal_redundant(solver, solver->_learnt[i])) {
+            solver->_learnt[j++] = solver->_learnt[i];
+        } else {
+            solver->_seen[LITERAL_VAR(solver->_learnt[i])] = false;
+        }
+    }
+    for (i = 1; i < size; i++) {
+        solver->_seen[LITERAL_VAR(solver->_learnt[i])] = false;
+    }
+    size = j;
+
+    /* move a literal of the highest level second (it will be watched) */
+    *level = 0;
+    if (size > 1) {
+        max_position = 1;
+        for (i = 2; i < size; i++) {
+            if (solver->_levels[LITERAL_VAR(solver->_learnt[i])] >
+                solver->_levels[LITERAL_VAR(solver->_learnt[max_position])]) {
+                max_position = i;
+            }
+        }
+        literal = solver->_learnt[max_position];
+        solver->_learnt[max_position] = solver->_learnt[1];
+        solver->_learnt[1] = literal;
+        *level = solver->_levels[LITERAL_VAR(literal)];
+    }
+    return size;
+}
+
+/* Adds the learnt clause, after backtracking, and assigns its first literal. */
+void learn_clause(SatSolver *solver, int size) {
+    int clause;
+
+    if (size == 1) {
+        assign_literal(solver, solver->_learnt[0], NO_CLAUSE);
+        return;
+    }
+    clause = allocate_clause(solver, solver->_learnt, size,
+                             (count_clause_levels(solver, size) << LBD_SHIFT) | LEARNT_FLAG);
+    append_clause_reference(&solver->_learnts, &solver->_num_of_learnts, &solver->_learnts_capacity, clause);
+    attach_clause(solver, clause);
+    assign_literal(solver, solver->_learnt[0], clause);
+}
+
+
+/* Dropping learnt clauses */
+
+/* A learnt clause and its LBD, for sorting */
+typedef struct {
+    int lbd;
+    int clause;
+} LearntEntry;
+
+/* Orders learnt clauses from the highest LBD, and the oldest first among
+ * equal LBDs. */
+int compare_learnt_entries(const void *first, const void *second) {
+    const LearntEntry *a = first, *b = second;
+
+    if (a->lbd != b->lbd) {
+        return b->lbd - a->lbd;
+    }
+    return a->clause - b->clause;
+}
+
+/* Drops half of the learnt clauses (the ones with the highest LBD), except
+ * for glue clauses. Must be called at level 0, where no clause is a reason
+ * that matters. The arena is compacted, and the watches are rebuilt. */
+void reduce_learnts(SatSolver *solver) {
+    int i, num_of_entries = 0, clause, size, header, write = 0, literal;
+    LearntEntry *entries = malloc((solver->_num_of_learnts + 1) * sizeof(LearntEntry));
+    validate_memory_allocation("reduce_learnts", entries);
+
+    for (i = 0; i < solver->_num_of_learnts; i++) {
+        clause = solver->_learnts[i];
+        if ((CLAUSE_HEADER(solver, clause) >> LBD_SHIFT) > GLUE_LBD) {
+            entries[num_of_entries].lbd = CLAUSE_HEADER(solver, clause) >> LBD_SHIFT;
+            entries[num_of_entries].clause = clause;
+            num_of_entries++;
+        }
+    }
+    qsort(entries, num_of_entries, sizeof(LearntEntry), compare_learnt_entries);
+    for (i = 0; i < num_of_entries / 2; i++) {
+        CLAUSE_HEADER(solver, entries[i].clause) |= DELETED_FLAG;
+    }
+    free(entries);
+
+    /* compact the arena, keeping the order of the clauses */
+    solver->_num_of_clauses = 0;
+    solver->_num_of_learnts = 0;
+    for (clause = 0; clause < solver->_arena_size; clause += size + CLAUSE_OVERHEAD) {
+        size = CLAUSE_SIZE(solver, clause);
+        header = CLAUSE_HEADER(solver, clause);
+        if (header & DELETED_FLAG) {
+            continue;
+        }
+        for (i = 0; i < size + CLAUSE_OVERHEAD; i++) {
+            solver->_arena[write + i] = solver->_arena[clause + i];
+        }
+        if (header & LEARNT_FLAG) {
+            solver->_learnts[solver->_num_of_learnts++] = write;
+        } else {
+            solver->_clauses[solver->_num_of_clauses++] = write;
+        }
+        write += size + CLAUSE_OVERHEAD;
+    }
+    solver->_arena_size = write;
+
+    for (literal = 0; literal < 2 * solver->num_of_vars; literal++) {
+        solver->_watches[literal].size = 0;
+    }
+    for (i = 0; i < solver->_num_of_clauses; i++) {
+        attach_clause(solver, solver->_clauses[i]);
+    }
+    for (i = 0; i < solver->_num_of_learnts; i++) {
+        attach_clause(solver, solver->_learnts[i]);
+    }
+    for (i = 0; i < solver->_trail_size; i++) {
+        solver->_reasons[LITERAL_VAR(solver->_trail[i])] = NO_CLAUSE;
+    }
+}
+
+
+/* Search */
+
+/* Returns the i-th element (zero-based) of the Luby sequence (1, 1, 2, 1, 1,
+ * 2, 4, 1, ...), which sets the number of conflicts between restarts. */
+unsigned long get_luby(unsigned long i) {
+    unsigned long size = 1, power = 1;
+
+    /* find the smallest complete subsequence (of size 2^k - 1) containing i */
+    while (size < i + 1) {
+        size = 2 * size + 1;
+        power *= 2;
+    }
+    while (size - 1 != i) {
+        size = (size - 1) / 2;
+        power /= 2;
+        i %= size;
+    }
+    return power;
+}
+
+/* Picks the unassigned variable of the highest activity, and returns the
+ * literal to decide (with the variable's last value), or UNASSIGNED if all
+ * the variables are assigned. */
+int pick_decision_literal(SatSolver *solver) {
+    int var;
+
+    while (solver->_heap_size > 0) {
+        var = remove_heap_max(solver);
+        if (solver->_values[var] == UNASSIGNED) {
+            return (solver->_phases[var] == VALUE_TRUE) ? POSITIVE_LITERAL(var) : NEGATIVE_LITERAL(var);
+        }
+    }
+    return UNASSIGNED;
+}
+
+/* Searches until a solution is found, the clauses are found unsatisfiable,
+ * or the given number of conflicts is reached. */
+SearchStatus search_sat(SatSolver *solver, unsigned long max_conflicts) {
+    int conflict, size, level, literal;
+    unsigned long num_of_conflicts = 0;
+
+    for (;;) {
+        conflict = propagate_sat(solver);
+        if (conflict != NO_CLAUSE) {
+            solver->num_of_conflicts++;
+            num_of_conflicts++;
+            if (solver->_num_of_levels == 0) {
+                return sat_unsatisfiable;
+            }
+            size = analyze_conflict(solver, conflict, &level);
+            backtrack_sat(solver, level);
+            learn_clause(solver, size);
+            solver->_activity_increment /= ACTIVITY_DECAY;
+            continue;
+        }
+
+        if (num_of_conflicts >= max_conflicts) {
+            backtrack_sat(solver, 0);
+            return sat_restart;
+        }
+
+        literal = pick_decision_literal(solver);
+        if (literal == UNASSIGNED) {
+            return sat_satisfiable;
+        }
+        solver->num_of_decisions++;
+        solver->_trail_limits[solver->_num_of_levels] = solver->_trail_size;
+        solver->_num_of_levels++;
+        assign_literal(solver, literal, NO_CLAUSE);
+    }
+}
+
+bool solve_sat(SatSolver *solver) {
+    int var;
+    unsigned long restart = 0;
+    SearchStatus status = sat_restart;
+
+    if (solver->unsatisfiable) {
+        return false;
+    }
+    if (solver->_max_learnts < solver->_num_of_clauses / 3) {
+        solver->_max_learnts = solver->_num_of_clauses / 3;
+    }
+
+    while (status == sat_restart) {
+        status = search_sat(solver, get_luby(restart) * RESTART_UNIT);
+        restart++;
+        if (status == sat_restart && solver->_num_of_learnts - solver->_trail_size >= solver->_max_learnts) {
+            reduce_learnts(solver);
+            solver->_max_learnts = (int) (solver->_max_learnts * LEARNTS_GROWTH);
+        }
+    }
+
+    if (status == sat_unsatisfiable) {
+        solver->unsatisfiable = true;
+        return false;
+    }
+    for (var = 0; var < solver->num_of_vars; var++) {
+        solver->model[var] = (solver->_values[var] == VALUE_TRUE);
+    }
+    backtrack_sat(solver, 0);
+    return true;
+}
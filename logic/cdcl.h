@@ -0,0 +1,117 @@
+#include <stdbool.h>
+
+#ifndef FINAL_PROJECT_CDCL_H
+#define FINAL_PROJECT_CDCL_H
+
+/** cdcl:
+ *
+ *  A conflict-driven clause learning SAT solver, for formulas in conjunctive
+ *  normal form. It propagates with two watched literals per clause, learns
+ *  a clause (the first unique implication point) from each conflict, picks
+ *  the variable to decide with VSIDS (the most active in recent conflicts)
+ *  and reuses its last value (phase saving), restarts on the Luby sequence,
+ *  and periodically drops half of the learnt clauses, keeping the ones that
+ *  span few decision levels (low LBD).
+ *  Variables are indexed from 0, and a literal is 2 * var for the variable
+ *  and 2 * var + 1 for its negation (see the macros below).
+ */
+
+#define POSITIVE_LITERAL(var) (2 * (var))
+#define NEGATIVE_LITERAL(var) (2 * (var) + 1)
+#define LITERAL_VAR(literal) ((literal) >> 1)
+#define NEGATE_LITERAL(literal) ((literal) ^ 1)
+
+/* A list of (clause reference, blocker literal) pairs: the clauses to visit
+ * when a literal becomes true (the clauses that watch its negation). The
+ * blocker is another literal of the clause; if it's true, the clause is
+ * satisfied and doesn't need to be visited. */
+typedef struct {
+    int *items;
+    int size;                 /* the number of ints used (twice the number of pairs) */
+    int capacity;
+} WatchList;
+
+/* All the fields are internal to the solver. Clauses are kept in a single
+ * arena, referenced by offset: [size, header (the LBD and flags), literals]. */
+typedef struct {
+    int num_of_vars;
+    int vars_capacity;        /* the number of variables the arrays can hold before they grow */
+    int *_arena;
+    int _arena_size;
+    int _arena_capacity;
+    int *_clauses;            /* the references of the problem clauses */
+    int _num_of_clauses;
+    int _clauses_capacity;
+    int *_learnts;            /* the references of the learnt clauses */
+    int _num_of_learnts;
+    int _learnts_capacity;
+    int _max_learnts;         /* the number of learnt clauses to keep before dropping some */
+    WatchList *_watches;      /* by literal */
+    signed char *_values;     /* the value of each variable (see the values in cdcl.c) */
+    int *_levels;             /* the decision level each variable was assigned at */
+    int *_reasons;            /* the clause that implied each variable (or NO_CLAUSE for decisions) */
+    double *_activities;      /* the VSIDS activity of each variable */
+    double _activity_increment;
+    signed char *_phases;     /* the last value of each variable */
+    signed char *_seen;       /* marks for conflict analysis */
+    int *_heap;               /* the unassigned variables, as a max heap of activity */
+    int _heap_size;
+    int *_heap_positions;     /* the position of each variable in the heap (-1 if not in it) */
+    bool *_decisions;         /* whether each variable can be decided (or is only implied) */
+    int *_trail;              /* the assigned literals, in order */
+    int _trail_size;
+    int _propagated;          /* the number of trail literals that were propagated */
+    int *_trail_limits;       /* the trail size at the start of each decision level */
+    int _num_of_levels;       /* the current decision level */
+    int *_learnt;             /* a buffer for the clause learnt from a conflict */
+    int *_level_stamps;       /* marks of the levels counted for the LBD of a learnt clause */
+    int _stamp;
+    signed char *model;       /* the value of each variable in the last solution (true/false) */
+    bool unsatisfiable;       /* set once the clauses were found to have no solution */
+    unsigned long num_of_conflicts;
+    unsigned long num_of_decisions;
+} SatSolver;
+
+/**
+ * Creates a new solver without variables or clauses.
+ * @return: the new solver that was created.
+ */
+SatSolver* create_sat_solver();
+
+/**
+ * Destroys the given solver (frees all related memory).
+ * @param solver: the solver to destroy.
+ */
+void destroy_sat_solver(SatSolver *solver);
+
+/**
+ * Adds a new variable to the solver.
+ * @param solver: the solver to add the variable to.
+ * @param is_decision: true if the search may decide the variable, and false
+ * for auxiliary variables whose values are implied by the decision variables
+ * once those are all assigned. Decision variables are tried as true first,
+ * and the rest as false.
+ * @return: the index of the new variable.
+ */
+int add_sat_variable(SatSolver *solver, bool is_decision);
+
+/**
+ * Adds a clause (a disjunction of literals) to the solver. Can also be used
+ * between calls to solve_sat (e.g. to exclude the previous solution).
+ * @param solver: the solver to add the clause to.
+ * @param literals: the literals of the clause (each variable at most once).
+ * @param size: the number of literals.
+ * @return: false if the clauses were found to have no solution, and true
+ * otherwise.
+ */
+bool add_sat_clause(SatSolver *solver, const int *literals, int size);
+
+/**
+ * Searches for an assignment that satisfies all the clauses.
+ * @param solver: the solver to run.
+ * @return: true if one was found (it is then kept in the solver's model), and
+ * false if there is none.
+ */
+bool solve_sat(SatSolver *solver);
+
+#endif
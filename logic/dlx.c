@@ -0,0 +1,263 @@
+#include <stdlib.h>
+#include "dlx.h"
+#include "backtracking.h"
+#include "../MemoryError.h"
+
+#define ROOT (0)
+#define NUM_OF_CONSTRAINT_TYPES (4)
+#define NOT_NEEDED (-1)
+
+/* The matrix nodes are kept in parallel arrays, indexed by node: ROOT, then
+ * the column headers (1..num_of_columns), then the nodes of the matrix rows
+ * (four consecutive nodes per row). Headers use 'up'/'down' for their column,
+ * and 'left'/'right' for the list of uncovered columns. */
+typedef struct {
+    int num_of_columns;
+    int num_of_nodes;
+    int *left;
+    int *right;
+    int *up;
+    int *down;
+    int *column;    /* the column header of each node */
+    int *sizes;     /* the number of nodes in each column (by header) */
+    int *_data;     /* the single allocation backing the arrays above */
+} DancingLinks;
+
+
+/* Maps each constraint to its column header, or NOT_NEEDED if the filled
+ * cells already satisfy it. The constraints are indexed by type (cell, row,
+ * column, block), and then by [cell] or by [unit * dim + value - 1]. Returns
+ * the number of columns. */
+int map_constraint_columns(const Board *board, int *columns) {
+    int row, column, value, dim = board->dim, num_of_columns = 0, i, block;
+
+    for (i = 0; i < NUM_OF_CONSTRAINT_TYPES * dim * dim; i++) {
+        columns[i] = 0;
+    }
+
+    /* mark the satisfied constraints */
+    for (row = 0; row < dim; row++) {
+        for (column = 0; column < dim; column++) {
+            value = get_cell_value(board, row, column);
+            if (value == CLEAR) {
+                continue;
+            }
+            block = get_block_index(board, row, column);
+            columns[row * dim + column] = NOT_NEEDED;
+            columns[dim * dim + row * dim + value - 1] = NOT_NEEDED;
+            columns[2 * dim * dim + column * dim + value - 1] = NOT_NEEDED;
+            columns[3 * dim * dim + block * dim + value - 1] = NOT_NEEDED;
+        }
+    }
+
+    for (i = 0; i < NUM_OF_CONSTRAINT_TYPES * dim * dim; i++) {
+        if (columns[i] != NOT_NEEDED) {
+            columns[i] = ++num_of_columns;
+        }
+    }
+    return num_of_columns;
+}
+
+/* Fills constraints with the column headers of the four constraints covered
+ * by placing the value in the cell at the given coordinates. */
+void get_row_constraints(const Board *board, const int *columns, int row, int column, int value, int *constraints) {
+    int dim = board->dim, block = get_block_index(board, row, column);
+
+    constraints[0] = columns[row * dim + column];
+    constraints[1] = columns[dim * dim + row * dim + value - 1];
+    constraints[2] = columns[2 * dim * dim + column * dim + value - 1];
+    constraints[3] = columns[3 * dim * dim + block * dim + value - 1];
+}
+
+/* Creates the Dancing Links matrix of the given board. */
+DancingLinks* create_dancing_links(const Board *board) {
+    int row, column, value, i, node, num_of_rows = 0, header, dim = board->dim;
+    int constraints[NUM_OF_CONSTRAINT_TYPES];
+    int *columns;
+    ValueSet candidates;
+    DancingLinks *dlx = malloc(sizeof(DancingLinks));
+    validate_memory_allocation("create_dancing_links", dlx);
+
+    columns = malloc(NUM_OF_CONSTRAINT_TYPES * dim * dim * sizeof(int));
+    validate_memory_allocation("create_dancing_links", columns);
+    dlx->num_of_columns = map_constraint_columns(board, columns);
+
+    for (row = 0; row < dim; row++) {
+        for (column = 0; column < dim; column++) {
+            if (is_cell_empty(board, row, column)) {
+                get_cell_candidates(board, &candidates, row, column);
+                num_of_rows += count_values(&candidates);
+            }
+        }
+    }
+
+    dlx->num_of_nodes = 1 + dlx->num_of_columns + NUM_OF_CONSTRAINT_TYPES * num_of_rows;
+    dlx->_data = malloc(6 * dlx->num_of_nodes * sizeof(int));
+    validate_memory_allocation("create_dancing_links", dlx->_data);
+    dlx->left = dlx->_data;
+    dlx->right = dlx->left + dlx->num_of_nodes;
+    dlx->up = dlx->right + dlx->num_of_nodes;
+    dlx->down = dlx->up + dlx->num_of_nodes;
+    dlx->column = dlx->down + dlx->num_of_nodes;
+    dlx->sizes = dlx->column + dlx->num_of_nodes;
+
+    /* the root and the headers form a circular list, each header starts as
+     * an empty column */
+    for (header = ROOT; header <= dlx->num_of_columns; header++) {
+        dlx->left[header] = (header == ROOT) ? dlx->num_of_columns : header - 1;
+        dlx->right[header] = (header == dlx->num_of_columns) ? ROOT : header + 1;
+        dlx->up[header] = header;
+        dlx->down[header] = header;
+        dlx->column[header] = header;
+        dlx->sizes[header] = 0;
+    }
+
+    node = dlx->num_of_columns + 1;
+    for (row = 0; row < dim; row++) {
+        for (column = 0; column < dim; column++) {
+            if (!is_cell_empty(board, row, column)) {
+                continue;
+            }
+            get_cell_candidates(board, &candidates, row, column);
+            for (value = get_next_value(&candidates, CLEAR); value != CLEAR; value = get_next_value(&candidates, value)) {
+                get_row_constraints(board, columns, row, column, value, constraints);
+
+                for (i = 0; i < NUM_OF_CONSTRAINT_TYPES; i++, node++) {
+                    header = constraints[i];
+                    /* link the node in its matrix row (circular) */
+                    dlx->left[node] = (i == 0) ? node + NUM_OF_CONSTRAINT_TYPES - 1 : node - 1;
+                    dlx->right[node] = (i == NUM_OF_CONSTRAINT_TYPES - 1) ? node - i : node + 1;
+                    /* append the node to the bottom of its column */
+                    dlx->column[node] = header;
+                    dlx->up[node] = dlx->up[header];
+                    dlx->down[node] = header;
+                    dlx->down[dlx->up[header]] = node;
+                    dlx->up[header] = node;
+                    dlx->sizes[header]++;
+                }
+            }
+        }
+    }
+
+    free(columns);
+    return dlx;
+}
+
+/* Destroys the given Dancing Links matrix (frees all related memory). */
+void destroy_dancing_links(DancingLinks *dlx) {
+    free(dlx->_data);
+    free(dlx);
+}
+
+/* Removes the given column from the header list, and removes all the matrix
+ * rows that have a node in it from their other columns. */
+void cover_column(DancingLinks *dlx, int header) {
+    int i, j;
+
+    dlx->right[dlx->left[header]] = dlx->right[header];
+    dlx->left[dlx->right[header]] = dlx->left[header];
+    for (i = dlx->down[header]; i != header; i = dlx->down[i]) {
+        for (j = dlx->right[i]; j != i; j = dlx->right[j]) {
+            dlx->down[dlx->up[j]] = dlx->down[j];
+            dlx->up[dlx->down[j]] = dlx->up[j];
+            dlx->sizes[dlx->column[j]]--;
+        }
+    }
+}
+
+/* Undoes cover_column (must be called in reverse order of the covers). */
+void uncover_column(DancingLinks *dlx, int header) {
+    int i, j;
+
+    for (i = dlx->up[header]; i != header; i = dlx->up[i]) {
+        for (j = dlx->left[i]; j != i; j = dlx->left[j]) {
+            dlx->sizes[dlx->column[j]]++;
+            dlx->down[dlx->up[j]] = j;
+            dlx->up[dlx->down[j]] = j;
+        }
+    }
+    dlx->right[dlx->left[header]] = header;
+    dlx->left[dlx->right[header]] = header;
+}
+
+/* Returns the uncovered column with the fewest nodes. */
+int choose_column(const DancingLinks *dlx) {
+    int header, best = dlx->right[ROOT];
+
+    for (header = dlx->right[best]; header != ROOT; header = dlx->right[header]) {
+        if (dlx->sizes[header] < dlx->sizes[best]) {
+            best = header;
+            if (dlx->sizes[best] <= 1) {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+void get_num_of_solutions_dlx(const Board *board, uint64_t limit, Count *counter, unsigned long *num_of_nodes) {
+    int level = 0, node, header, j;
+    int *columns, *rows;
+    bool descend = true;
+    DancingLinks *dlx = create_dancing_links(board);
+
+    set_count_value(counter, 0);
+    if (num_of_nodes != NULL) {
+        *num_of_nodes = 0;
+    }
+
+    /* a cover selects one row per empty cell, so the depth is bounded by the
+     * number of columns */
+    columns = malloc(2 * (dlx->num_of_columns + 1) * sizeof(int));
+    validate_memory_allocation("get_num_of_solutions_dlx", columns);
+    rows = columns + dlx->num_of_columns + 1;
+
+    /* rows[level] is the row that's selected at each level (its first node),
+     * or the level's column header before any row was selected */
+    while (level >= 0) {
+        if (descend) {
+            if (dlx->right[ROOT] == ROOT) { /* all constraints are covered */
+                add_to_count(counter, 1);
+                if (limit != NO_SOLUTIONS_LIMIT && is_count_at_least(counter, limit)) {
+                    break; /* the matrix is discarded, no need to uncover */
+                }
+                level--;
+                descend = false;
+                continue;
+            }
+            header = choose_column(dlx);
+            cover_column(dlx, header);
+            columns[level] = header;
+            rows[level] = header;
+        }
+
+        header = columns[level];
+        node = rows[level];
+        if (node != header) { /* deselect the previous row of this level */
+            for (j = dlx->left[node]; j != node; j = dlx->left[j]) {
+                uncover_column(dlx, dlx->column[j]);
+            }
+        }
+
+        node = dlx->down[node];
+        rows[level] = node;
+        if (node == header) { /* no more rows to try, backtrack */
+            uncover_column(dlx, header);
+            level--;
+            descend = false;
+            continue;
+        }
+
+        for (j = dlx->right[node]; j != node; j = dlx->right[j]) {
+            cover_column(dlx, dlx->column[j]);
+        }
+        if (num_of_nodes != NULL) {
+            (*num_of_nodes)++;
+        }
+        level++;
+        descend = true;
+    }
+
+    free(columns);
+    destroy_dancing_links(dlx);
+}
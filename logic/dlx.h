@@ -0,0 +1,31 @@
+#include "../components/Board.h"
+#include "../components/Count.h"
+
+#ifndef FINAL_PROJECT_DLX_H
+#define FINAL_PROJECT_DLX_H
+
+/** Dancing Links:
+ *
+ *  Counts the solutions of a board as an exact cover problem (Knuth's
+ *  Algorithm X over a Dancing Links matrix).
+ *  The matrix has a row for each (empty cell, legal value) pair, and a column
+ *  for each constraint that isn't satisfied by the filled cells yet, from the
+ *  same four families the ILP solver uses: each empty cell has a value, and
+ *  each row, column and block contains each value once.
+ *  The matrix is built once per count, and the search itself doesn't
+ *  allocate memory.
+ */
+
+/**
+ * Counts the solutions of the board, using Dancing Links.
+ * The board must not be erroneous.
+ * @param board: the board to get the number of solutions for.
+ * @param limit: the number of solutions to stop the search at, or
+ * NO_SOLUTIONS_LIMIT (see backtracking.h) to count all of them.
+ * @param counter: an initialized count, set to the number of solutions.
+ * @param num_of_nodes: pointer to be updated with the number of rows the
+ * search selected (may be NULL).
+ */
+void get_num_of_solutions_dlx(const Board *board, uint64_t limit, Count *counter, unsigned long *num_of_nodes);
+
+#endif
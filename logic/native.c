@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include "native.h"
+#include "search.h"
+#include "backtracking.h"
+#include "../components/Stack.h"
+#include "../MemoryError.h"
+
+#define NO_START_RANK (0)
+
+/* The outcomes of expanding a node of the search */
+typedef enum {
+    dead_end,
+    branch,
+    solved
+} NodeStatus;
+
+
+/* Propagates the constraints at the current node of the search, and selects
+ * the cell to branch on (empty_cells[depth]) if the node isn't solved. */
+NodeStatus expand_solution_node(Search *search) {
+    if (!propagate(search)) {
+        return dead_end;
+    }
+    if (search->depth == search->num_of_empty) {
+        return solved;
+    }
+    return (select_most_constrained_cell(search) > 0) ? branch : dead_end;
+}
+
+/* Gets the value of the cell to try after val (CLEAR to get the first), or
+ * CLEAR once all its candidates were tried. The candidates are tried in
+ * increasing order, or, if start_rank isn't NO_START_RANK, in cyclic order
+ * from the candidate of that rank (counted from 1, wrapping around). */
+int get_next_search_value(const ValueSet *candidates, int val, long start_rank, int N) {
+    int next, start = CLEAR, num_of_candidates = count_values(candidates);
+    long i;
+
+    if (start_rank == NO_START_RANK || num_of_candidates == 0) {
+        return get_next_value(candidates, val);
+    }
+    for (i = (start_rank - 1) % num_of_candidates; i >= 0; i--) {
+        start = get_next_value(candidates, start);
+    }
+
+    next = get_next_value(candidates, (val == CLEAR) ? start - 1 : val);
+    if (next == CLEAR) {
+        next = get_next_value(candidates, CLEAR); /* wrap around */
+    }
+    if (val != CLEAR && (next - start + N) % N <= (val - start + N) % N) {
+        return CLEAR; /* back at the first candidate */
+    }
+    return next;
+}
+
+/* Searches for a solution of the search's board, trying the values of each
+ * cell from its start rank (see get_next_search_value; start_ranks may be
+ * NULL), for at most max_nodes decisions. If one was found, the search's
+ * board holds it (inside the trail levels opened by the search, which the
+ * caller closes). */
+SolveStatus search_solution(Search *search, Stack *stack, const long *start_ranks, unsigned long max_nodes) {
+    int row, column, val = CLEAR, cell, N = search->board->dim;
+    NodeStatus status;
+    ValueSet candidates;
+
+    status = expand_solution_node(search);
+    while (status != solved) {
+        if (status == branch) {
+            cell = search->empty_cells[search->depth];
+            row = cell / N;
+            column = cell % N;
+            val = CLEAR;
+        } else {
+            if (is_stack_empty(stack)) {
+                return search_unsolvable; /* can't backtrack */
+            }
+            backtrack_to_stack_top(search->board, stack, &row, &column, &val);
+            search->depth = search->positions[row * N + column]; /* the decided cell stays in place */
+            cell = row * N + column;
+        }
+
+        get_cell_candidates(search->board, &candidates, row, column);
+        val = get_next_search_value(&candidates, val, (start_ranks == NULL) ? NO_START_RANK : start_ranks[cell], N);
+        if (val == CLEAR) {
+            status = dead_end; /* all the values of the cell were tried */
+            continue;
+        }
+        if (max_nodes != NO_NODE_LIMIT && search->num_of_nodes >= max_nodes) {
+            return search_limit_reached;
+        }
+
+        push_level(search->board);
+        assign_cell(search, cell, val);
+        push(row, column, val, stack);
+        search->num_of_nodes++;
+        status = expand_solution_node(search);
+    }
+    return search_solved;
+}
+
+SolveStatus find_solution_from(Board *board, const long *start_ranks, unsigned long max_nodes) {
+    int i, cell, N = board->dim, level = get_level(board), *values;
+    bool found;
+    SolveStatus status;
+    Search *search;
+    Stack *stack;
+
+    if (is_board_erroneous(board)) {
+        return search_unsolvable;
+    }
+
+    search = create_search(board);
+    stack = create_stack(search->num_of_empty);
+
+    push_level(board); /* the root level, for the cells propagated before any decision */
+    status = search_solution(search, stack, start_ranks, max_nodes);
+    found = (status == search_solved);
+
+    /* keep the solution's values, and undo the search */
+    values = malloc((search->num_of_empty + 1) * sizeof(int)); /* not empty, even for a full board */
+    validate_memory_allocation("find_solution", values);
+    if (found) {
+        for (i = 0; i < search->num_of_empty; i++) {
+            cell = search->empty_cells[i];
+            values[i] = get_cell_value(board, cell / N, cell % N);
+        }
+    }
+    while (get_level(board) > level) {
+        pop_level(board);
+    }
+
+    if (found) {
+        for (i = 0; i < search->num_of_empty; i++) {
+            cell = search->empty_cells[i];
+            set_cell_value(board, cell / N, cell % N, values[i]);
+        }
+    }
+
+    free(values);
+    destroy_stack(stack);
+    destroy_search(search);
+    return status;
+}
+
+bool find_solution(Board *board) {
+    return find_solution_from(board, NULL, NO_NODE_LIMIT) == search_solved;
+}
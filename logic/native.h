@@ -0,0 +1,54 @@
+#include <stdbool.h>
+#include "../components/Board.h"
+
+#ifndef FINAL_PROJECT_NATIVE_H
+#define FINAL_PROJECT_NATIVE_H
+
+/** native:
+ *
+ *  The built-in exact solver, which needs no external libraries. It's an
+ *  exhaustive search that propagates the constraints at each node (naked and
+ *  hidden singles, see the Search module) and always branches on the most
+ *  constrained empty cell, so most boards are solved with little or no
+ *  backtracking.
+ */
+
+#define NO_NODE_LIMIT (0)
+
+/* The outcomes of a search for a solution */
+typedef enum {
+    search_solved,
+    search_unsolvable,
+    search_limit_reached    /* gave up, without knowing whether there's a solution */
+} SolveStatus;
+
+/**
+ * Fills the empty cells of the board with a solution, if it has one.
+ * @param board: the board to solve. Left unchanged if it can't be solved.
+ * @return: true if the board was solved, and false if it has no solution
+ * (including erroneous boards).
+ */
+bool find_solution(Board *board);
+
+/**
+ * Fills the empty cells of the board with a solution, if it has one, trying
+ * the legal values of each cell in cyclic order, from the one at its start
+ * rank. E.g. random ranks from a range much larger than dim make each
+ * decision pick a uniformly random value, for a random solution (see
+ * sampling.h). A randomized search can get stuck in a large unsolvable
+ * subtree, so it can be given up after a number of decisions, to restart it
+ * with other ranks.
+ * @param board: the board to solve. Left unchanged if it can't be solved.
+ * @param start_ranks: the rank of the value to start from for each cell (by
+ * cell index, row * dim + column), a positive number that wraps around the
+ * cell's legal values (1 is the smallest). NULL tries the values in
+ * increasing order.
+ * @param max_nodes: the number of decisions after which the search is given
+ * up, or NO_NODE_LIMIT.
+ * @return: search_solved if the board was solved, search_unsolvable if it has
+ * no solution (including erroneous boards), and search_limit_reached if the
+ * search was given up (the board is left unchanged).
+ */
+SolveStatus find_solution_from(Board *board, const long *start_ranks, unsigned long max_nodes);
+
+#endif
@@ -0,0 +1,321 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "parallel.h"
+#include "backtracking.h"
+#include "../components/Stack.h"
+#include "../MemoryError.h"
+
+#define THREADS_ENV_VAR "SUDOKU_THREADS"
+#define MAX_THREADS (256)
+#define TASKS_PER_THREAD (32) /* enough tasks to balance uneven subtrees */
+#define NO_TASK (-1)
+
+typedef struct {
+    int *tasks;
+    int top;        /* the next task to be stolen */
+    int bottom;     /* one past the next task of the owner */
+    pthread_mutex_t lock;
+} TaskDeque;
+
+typedef struct {
+    Search *search;             /* the search over the state all the tasks start from */
+    int depth;                  /* the number of decisions of each task */
+    int *assignments;           /* the decisions, (cell, value) pairs ([(task * depth + i) * 2]) */
+    Count *weights;             /* the number of solutions each completion of a task stands for */
+    int num_of_tasks;
+    int tasks_capacity;
+    Count solutions;            /* the solutions found while splitting */
+    int num_of_workers;
+    TaskDeque *deques;          /* a deque per worker */
+} CountingPool;
+
+typedef struct {
+    CountingPool *pool;
+    int id;
+    Board *board;               /* the worker's scratch board */
+    Search *search;
+    Stack *stack;
+    Count counter;
+    pthread_t thread;
+} Worker;
+
+
+int get_num_of_threads() {
+    const char *value = getenv(THREADS_ENV_VAR);
+    long num_of_threads = 0;
+
+    if (value != NULL) {
+        num_of_threads = strtol(value, NULL, 10);
+    }
+    if (num_of_threads <= 0) {
+        num_of_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
+    if (num_of_threads < 1) {
+        return 1;
+    }
+    return (num_of_threads > MAX_THREADS) ? MAX_THREADS : (int) num_of_threads;
+}
+
+
+/* Splitting */
+
+/* Adds a task with the given assignments and weight to the pool. */
+void add_task(CountingPool *pool, const int *path, const Count *weight) {
+    int i;
+
+    if (pool->num_of_tasks == pool->tasks_capacity) {
+        pool->tasks_capacity = (pool->tasks_capacity > 0) ? 2 * pool->tasks_capacity : TASKS_PER_THREAD;
+        pool->assignments = realloc(pool->assignments, pool->tasks_capacity * pool->depth * 2 * sizeof(int));
+        validate_memory_allocation("add_task", pool->assignments);
+        pool->weights = realloc(pool->weights, pool->tasks_capacity * sizeof(Count));
+        validate_memory_allocation("add_task", pool->weights);
+        for (i = pool->num_of_tasks; i < pool->tasks_capacity; i++) {
+            init_count(&pool->weights[i]);
+        }
+    }
+
+    memcpy(pool->assignments + pool->num_of_tasks * pool->depth * 2, path, pool->depth * 2 * sizeof(int));
+    set_count(&pool->weights[pool->num_of_tasks], weight);
+    pool->num_of_tasks++;
+}
+
+/* Frees the tasks of the pool. */
+void free_tasks(CountingPool *pool) {
+    int i;
+
+    for (i = 0; i < pool->tasks_capacity; i++) {
+        free_count(&pool->weights[i]);
+    }
+    free(pool->weights);
+    free(pool->assignments);
+    pool->weights = NULL;
+    pool->assignments = NULL;
+    pool->tasks_capacity = 0;
+    pool->num_of_tasks = 0;
+}
+
+/* Expands the search tree below the given decision level, down to the pool's
+ * task depth. Each node at that depth becomes a task, and solutions that are
+ * found higher up are counted directly. weights[level] is the weight of the
+ * current node (see count_completions). */
+void split_tasks(CountingPool *pool, int level, int *path, Count *weights) {
+    Search *search = pool->search;
+    Board *board = search->board;
+    int cell, val, symmetric_value, multiplicity, depth = search->depth, branch_depth, N = board->dim;
+    ValueSet values;
+
+    if (level == pool->depth) {
+        add_task(pool, path, &weights[level]);
+        return;
+    }
+
+    push_level(board);
+    if (expand_node(search, &weights[level], &pool->solutions)) {
+        branch_depth = search->depth;
+        cell = search->empty_cells[branch_depth];
+        multiplicity = get_branch_values(board, &values, cell / N, cell % N, &symmetric_value);
+
+        for (val = get_next_value(&values, CLEAR); val != CLEAR; val = get_next_value(&values, val)) {
+            set_count(&weights[level + 1], &weights[level]);
+            if (val == symmetric_value) {
+                multiply_count(&weights[level + 1], multiplicity);
+            }
+            push_level(board);
+            assign_cell(search, cell, val);
+            search->num_of_nodes++;
+            path[2 * level] = cell;
+            path[2 * level + 1] = val;
+            split_tasks(pool, level + 1, path, weights);
+            pop_level(board);
+            search->depth = branch_depth;
+        }
+    }
+    pop_level(board);
+    search->depth = depth;
+}
+
+/* Splits the search into tasks, deepening the split until there are enough
+ * tasks for the pool's workers (or the tree is exhausted). */
+void create_tasks(CountingPool *pool) {
+    int i, num_of_empty = pool->search->num_of_empty;
+    int *path = malloc((num_of_empty + 1) * 2 * sizeof(int));
+    Count *weights = malloc((num_of_empty + 1) * sizeof(Count));
+    validate_memory_allocation("create_tasks", path);
+    validate_memory_allocation("create_tasks", weights);
+
+    for (i = 0; i <= num_of_empty; i++) {
+        init_count(&weights[i]);
+    }
+    set_count_value(&weights[0], 1);
+
+    for (pool->depth = 1; ; pool->depth++) {
+        set_count_value(&pool->solutions, 0);
+        pool->search->num_of_nodes = 0;
+        split_tasks(pool, 0, path, weights);
+
+        if (pool->num_of_tasks == 0 || pool->num_of_tasks >= TASKS_PER_THREAD * pool->num_of_workers
+            || pool->depth >= num_of_empty) {
+            break;
+        }
+        free_tasks(pool); /* the deeper split starts over */
+    }
+
+    for (i = 0; i <= num_of_empty; i++) {
+        free_count(&weights[i]);
+    }
+    free(weights);
+    free(path);
+}
+
+
+/* Work stealing */
+
+/* Deals the tasks to the workers' deques (round robin, so each worker gets
+ * tasks from all over the tree). */
+void create_deques(CountingPool *pool) {
+    int worker, task, capacity = pool->num_of_tasks / pool->num_of_workers + 1;
+
+    pool->deques = malloc(pool->num_of_workers * sizeof(TaskDeque));
+    validate_memory_allocation("create_deques", pool->deques);
+
+    for (worker = 0; worker < pool->num_of_workers; worker++) {
+        pool->deques[worker].tasks = malloc(capacity * sizeof(int));
+        validate_memory_allocation("create_deques", pool->deques[worker].tasks);
+        pool->deques[worker].top = 0;
+        pool->deques[worker].bottom = 0;
+        pthread_mutex_init(&pool->deques[worker].lock, NULL);
+    }
+
+    for (task = 0; task < pool->num_of_tasks; task++) {
+        worker = task % pool->num_of_workers;
+        pool->deques[worker].tasks[pool->deques[worker].bottom++] = task;
+    }
+}
+
+void destroy_deques(CountingPool *pool) {
+    int worker;
+
+    for (worker = 0; worker < pool->num_of_workers; worker++) {
+        pthread_mutex_destroy(&pool->deques[worker].lock);
+        free(pool->deques[worker].tasks);
+    }
+    free(pool->deques);
+}
+
+/* Takes the next task of the given worker: from the bottom of its own deque,
+ * or stolen from the top of another worker's deque. Returns NO_TASK once all
+ * the deques are empty (tasks never create new tasks, so there's no more work). */
+int take_task(CountingPool *pool, int id) {
+    int i, task = NO_TASK;
+    TaskDeque *deque;
+
+    for (i = 0; i < pool->num_of_workers && task == NO_TASK; i++) {
+        deque = &pool->deques[(id + i) % pool->num_of_workers];
+
+        pthread_mutex_lock(&deque->lock);
+        if (deque->bottom > deque->top) {
+            task = (i == 0) ? deque->tasks[--deque->bottom] : deque->tasks[deque->top++];
+        }
+        pthread_mutex_unlock(&deque->lock);
+    }
+    return task;
+}
+
+/* Counts the solutions of a single task on the worker's scratch board (into
+ * the worker's counter). The task's decisions are replayed as split_tasks made
+ * them, propagating before each one, so the worker starts from the board the
+ * serial search has at that node. */
+void run_task(Worker *worker, int task) {
+    CountingPool *pool = worker->pool;
+    const int *assignments = pool->assignments + task * pool->depth * 2;
+    int i;
+
+    restore_board(worker->board, pool->search->board);
+    worker->search->depth = 0;
+    for (i = 0; i < pool->depth; i++) {
+        propagate(worker->search); /* can't fail, it didn't when the task was split */
+        assign_cell(worker->search, assignments[2 * i], assignments[2 * i + 1]);
+    }
+
+    count_completions(worker->search, worker->stack, &pool->weights[task], NO_SOLUTIONS_LIMIT, &worker->counter);
+}
+
+void* run_worker(void *arg) {
+    Worker *worker = arg;
+    int task;
+
+    while ((task = take_task(worker->pool, worker->id)) != NO_TASK) {
+        run_task(worker, task);
+    }
+    return NULL;
+}
+
+
+void count_completions_in_parallel(Search *search, int num_of_threads, Count *counter) {
+    int i;
+    bool *started;
+    Worker *workers;
+    CountingPool pool;
+
+    pool.search = search;
+    pool.assignments = NULL;
+    pool.weights = NULL;
+    pool.num_of_tasks = 0;
+    pool.tasks_capacity = 0;
+    pool.num_of_workers = num_of_threads;
+    init_count(&pool.solutions);
+
+    create_tasks(&pool);
+    add_count(counter, &pool.solutions);
+    free_count(&pool.solutions);
+    if (pool.num_of_tasks == 0) {
+        free_tasks(&pool);
+        return;
+    }
+
+    if (pool.num_of_workers > pool.num_of_tasks) {
+        pool.num_of_workers = pool.num_of_tasks;
+    }
+    create_deques(&pool);
+
+    workers = malloc(pool.num_of_workers * sizeof(Worker));
+    validate_memory_allocation("count_completions_in_parallel", workers);
+    started = malloc(pool.num_of_workers * sizeof(bool));
+    validate_memory_allocation("count_completions_in_parallel", started);
+
+    for (i = 0; i < pool.num_of_workers; i++) {
+        workers[i].pool = &pool;
+        workers[i].id = i;
+        workers[i].board = get_board_copy(search->board);
+        workers[i].search = create_search(workers[i].board);
+        workers[i].stack = create_stack(search->num_of_empty);
+        init_count(&workers[i].counter);
+    }
+
+    /* the calling thread is worker 0. If a thread can't be started, its
+     * tasks are stolen by the other workers */
+    for (i = 1; i < pool.num_of_workers; i++) {
+        started[i] = (pthread_create(&workers[i].thread, NULL, run_worker, &workers[i]) == 0);
+    }
+    run_worker(&workers[0]);
+
+    for (i = 0; i < pool.num_of_workers; i++) {
+        if (i > 0 && started[i]) {
+            pthread_join(workers[i].thread, NULL);
+        }
+        add_count(counter, &workers[i].counter);
+        free_count(&workers[i].counter);
+        search->num_of_nodes += workers[i].search->num_of_nodes;
+        destroy_search(workers[i].search);
+        destroy_board(workers[i].board);
+        destroy_stack(workers[i].stack);
+    }
+
+    free(started);
+    free(workers);
+    destroy_deques(&pool);
+    free_tasks(&pool);
+}
@@ -0,0 +1,39 @@
+#include "../components/Board.h"
+#include "../components/Count.h"
+#include "search.h"
+
+#ifndef FINAL_PROJECT_PARALLEL_H
+#define FINAL_PROJECT_PARALLEL_H
+
+/** Parallel:
+ *
+ *  Splits the counting of a board's solutions between multiple threads.
+ *  The search tree is expanded to a small depth, and each node at that depth
+ *  becomes a task (the assignments that lead to it). The tasks are dealt to
+ *  the deques of a pool of workers, and each worker counts its own tasks on
+ *  its own scratch board, and steals tasks from the other deques once its
+ *  own deque is empty. The only locks are on the deques, so the search itself
+ *  never waits for another thread.
+ */
+
+/**
+ * Gets the number of threads to use for counting: the value of the
+ * SUDOKU_THREADS environment variable if it's set to a positive number, and
+ * the number of online processors otherwise.
+ * @return: the number of threads to use (at least 1).
+ */
+int get_num_of_threads();
+
+/**
+ * Counts the ways to complete the board of the search (its solutions) using
+ * multiple threads, and adds them to the counter. The board is back in its
+ * original state when the function returns, and the decisions made by all
+ * the threads are added to the search's num_of_nodes.
+ * @param search: the search to run, from depth 0. Its board must not be
+ * erroneous.
+ * @param num_of_threads: the number of threads to use.
+ * @param counter: the count to add the solutions to.
+ */
+void count_completions_in_parallel(Search *search, int num_of_threads, Count *counter);
+
+#endif
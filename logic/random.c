@@ -1,6 +1,7 @@
 #include <time.h>
 #include <stdlib.h>
 #include "random.h"
+#include "../components/SplitMix64.h"
 
 void initialize_random() {
     srand((unsigned int) time(NULL));
@@ -11,6 +12,11 @@ int get_rand_index(int limit) {
     return rand() % limit;
 }
 
+int get_rand_index_from(uint64_t *state, int limit) {
+    *state += SPLITMIX_GAMMA;
+    return (int) (mix_splitmix_bits(*state) % (uint64_t) limit);
+}
+
 void shuffle(int *array, int size_to_shuffle, int total_size) {
     int i, rand_index, temp;
 
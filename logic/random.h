@@ -1,6 +1,8 @@
 #ifndef FINAL_PROJECT_RANDOM_H
 #define FINAL_PROJECT_RANDOM_H
 
+#include <stdint.h>
+
 #define ERROR_VALUE (-1)
 
 /**
@@ -15,6 +17,17 @@ void initialize_random();
  */
 int get_rand_index(int limit);
 
+/**
+ * Get a random index between 0 and limit from a generator whose state is kept
+ * by the caller (SplitMix64, see SplitMix64.h), unlike get_rand_index which shares the state of
+ * rand. This lets each thread draw its own random numbers.
+ * @param state: the state of the generator (any value to start with, e.g. a
+ * seed drawn with get_rand_index). Advanced by the call.
+ * @param limit: the limit of the random int range.
+ * @return: random index between 0 and limit.
+ */
+int get_rand_index_from(uint64_t *state, int limit);
+
 /**
  * Shuffles the first <size_to_shuffle> indices of an array of size <total_size>
  * @param array: the array to shuffle.
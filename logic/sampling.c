@@ -0,0 +1,192 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "sampling.h"
+#include "native.h"
+#include "sinkhorn.h"
+#include "parallel.h"
+#include "random.h"
+#include "../MemoryError.h"
+
+#define SAMPLES_ENV_VAR "SUDOKU_SAMPLES"
+#define TIME_ENV_VAR "SUDOKU_SAMPLE_MS"
+#define SEED_RANGE (1 << 30)
+#define RANK_RANGE (1 << 30) /* makes the ranks' remainders uniform enough */
+#define NODE_LIMIT_FACTOR (2) /* the decisions of a sample's first try, per empty cell */
+
+typedef struct {
+    const Board *board;
+    long num_of_samples;        /* the sample budget */
+    long num_of_started;        /* the samples that were handed out */
+    long time_limit;            /* in milliseconds */
+    struct timeval start;
+    bool unsolvable;            /* set once a sample found no solution */
+    pthread_mutex_t lock;
+} SamplingPool;
+
+typedef struct {
+    SamplingPool *pool;
+    Board *board;               /* the sampler's scratch board */
+    long *start_ranks;          /* the random start rank of each cell (see find_solution_from) */
+    uint64_t random_state;
+    unsigned long *tallies;     /* the number of samples with each value ([cell * dim + value - 1]) */
+    long num_of_samples;        /* the samples this sampler drew */
+    pthread_t thread;
+} Sampler;
+
+
+/* Gets a positive number from the environment variable, or the default if it
+ * isn't set to one. */
+long get_sampling_setting(const char *name, long default_value) {
+    const char *value = getenv(name);
+    long setting = 0;
+
+    if (value != NULL) {
+        setting = strtol(value, NULL, 10);
+    }
+    return (setting > 0) ? setting : default_value;
+}
+
+/* Gets the milliseconds that passed since the pool started sampling. */
+long get_sampling_time(const SamplingPool *pool) {
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    return (now.tv_sec - pool->start.tv_sec) * 1000L + (now.tv_usec - pool->start.tv_usec) / 1000L;
+}
+
+/* Hands out the next sample to draw. Returns false once the budget is used
+ * up (or the board was found to be unsolvable). */
+bool take_sample(SamplingPool *pool) {
+    bool taken;
+
+    pthread_mutex_lock(&pool->lock);
+    taken = !pool->unsolvable && pool->num_of_started < pool->num_of_samples &&
+            get_sampling_time(pool) < pool->time_limit;
+    if (taken) {
+        pool->num_of_started++;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return taken;
+}
+
+/* Draws a random solution on the sampler's scratch board, and tallies its
+ * values. A search that takes too many decisions is restarted with new random
+ * ranks (and twice the decisions, so the sample is still found if it needs
+ * them), until the time budget runs out. Returns search_limit_reached if it
+ * ran out, and search_unsolvable if there's no solution. */
+SolveStatus draw_sample(Sampler *sampler) {
+    int cell, dim = sampler->board->dim;
+    unsigned long max_nodes = NODE_LIMIT_FACTOR * (unsigned long) (sampler->pool->board->empty_count + 1);
+    SolveStatus status;
+
+    restore_board(sampler->board, sampler->pool->board);
+    do {
+        for (cell = 0; cell < dim * dim; cell++) {
+            sampler->start_ranks[cell] = 1 + get_rand_index_from(&sampler->random_state, RANK_RANGE);
+        }
+        status = find_solution_from(sampler->board, sampler->start_ranks, max_nodes);
+        max_nodes *= 2;
+    } while (status == search_limit_reached && get_sampling_time(sampler->pool) < sampler->pool->time_limit);
+    if (status != search_solved) {
+        return status;
+    }
+
+    for (cell = 0; cell < dim * dim; cell++) {
+        if (is_cell_empty(sampler->pool->board, cell / dim, cell % dim)) {
+            sampler->tallies[cell * dim + get_cell_value(sampler->board, cell / dim, cell % dim) - 1]++;
+        }
+    }
+    sampler->num_of_samples++;
+    return search_solved;
+}
+
+void* run_sampler(void *arg) {
+    Sampler *sampler = arg;
+
+    while (take_sample(sampler->pool)) {
+        if (draw_sample(sampler) == search_unsolvable) {
+            pthread_mutex_lock(&sampler->pool->lock);
+            sampler->pool->unsolvable = true;
+            pthread_mutex_unlock(&sampler->pool->lock);
+        }
+    }
+    return NULL;
+}
+
+bool get_sampled_marginals(const Board *board, double *scores) {
+    int i, j, num_of_samplers, dim = board->dim;
+    long num_of_samples = 0;
+    bool *started;
+    Sampler *samplers;
+    SamplingPool pool;
+
+    if (is_board_erroneous(board)) {
+        return false;
+    }
+
+    pool.board = board;
+    pool.num_of_samples = get_sampling_setting(SAMPLES_ENV_VAR, DEFAULT_NUM_OF_SAMPLES);
+    pool.num_of_started = 0;
+    pool.time_limit = get_sampling_setting(TIME_ENV_VAR, DEFAULT_SAMPLE_MS);
+    pool.unsolvable = false;
+    pthread_mutex_init(&pool.lock, NULL);
+    gettimeofday(&pool.start, NULL);
+
+    num_of_samplers = get_num_of_threads();
+    if (num_of_samplers > pool.num_of_samples) {
+        num_of_samplers = (int) pool.num_of_samples;
+    }
+    samplers = malloc(num_of_samplers * sizeof(Sampler));
+    validate_memory_allocation("get_sampled_marginals", samplers);
+    started = malloc(num_of_samplers * sizeof(bool));
+    validate_memory_allocation("get_sampled_marginals", started);
+
+    for (i = 0; i < num_of_samplers; i++) {
+        samplers[i].pool = &pool;
+        samplers[i].board = get_board_copy(board);
+        samplers[i].start_ranks = malloc(dim * dim * sizeof(long));
+        validate_memory_allocation("get_sampled_marginals", samplers[i].start_ranks);
+        samplers[i].random_state = (uint64_t) get_rand_index(SEED_RANGE);
+        samplers[i].tallies = calloc(dim * dim * dim, sizeof(unsigned long));
+        validate_memory_allocation("get_sampled_marginals", samplers[i].tallies);
+        samplers[i].num_of_samples = 0;
+    }
+
+    /* the calling thread is sampler 0. If a thread can't be started, the
+     * other samplers draw its share */
+    for (i = 1; i < num_of_samplers; i++) {
+        started[i] = (pthread_create(&samplers[i].thread, NULL, run_sampler, &samplers[i]) == 0);
+    }
+    run_sampler(&samplers[0]);
+
+    for (j = 0; j < dim * dim * dim; j++) {
+        scores[j] = 0.0;
+    }
+    for (i = 0; i < num_of_samplers; i++) {
+        if (i > 0 && started[i]) {
+            pthread_join(samplers[i].thread, NULL);
+        }
+        for (j = 0; j < dim * dim * dim; j++) {
+            scores[j] += (double) samplers[i].tallies[j];
+        }
+        num_of_samples += samplers[i].num_of_samples;
+        destroy_board(samplers[i].board);
+        free(samplers[i].start_ranks);
+        free(samplers[i].tallies);
+    }
+    if (num_of_samples > 0) {
+        for (j = 0; j < dim * dim * dim; j++) {
+            scores[j] /= (double) num_of_samples;
+        }
+    }
+
+    free(started);
+    free(samplers);
+    pthread_mutex_destroy(&pool.lock);
+    if (pool.unsolvable) {
+        return false;
+    }
+    /* not even one sample was drawn in time */
+    return (num_of_samples > 0) ? true : get_sinkhorn_marginals(board, scores);
+}
@@ -0,0 +1,43 @@
+#include <stdbool.h>
+#include "../components/Board.h"
+
+#ifndef FINAL_PROJECT_SAMPLING_H
+#define FINAL_PROJECT_SAMPLING_H
+
+/** sampling:
+ *
+ *  Estimates the probability of each value of each empty cell by drawing
+ *  random solutions of the board and counting how often each value shows up.
+ *  Each solution is found by the native solver with every decision trying a
+ *  random legal value first (see find_solution_from). The samples aren't
+ *  exactly uniform over the solutions (a solution that's found by more
+ *  search paths is drawn more often), but unlike LP scores the frequencies
+ *  are real probabilities over solutions.
+ *  The samples are drawn by a pool of threads (as many as for counting, see
+ *  get_num_of_threads), each with its own scratch board and random generator,
+ *  until the sample budget (the SUDOKU_SAMPLES environment variable,
+ *  DEFAULT_NUM_OF_SAMPLES if it isn't set) is used up, or until the time
+ *  budget in milliseconds (SUDOKU_SAMPLE_MS, DEFAULT_SAMPLE_MS if it isn't
+ *  set) runs out. The randomized search can take very long on large boards
+ *  when an early decision leads it into an unsolvable subtree, so a sample is
+ *  restarted from new random decisions after a number of them (which doubles
+ *  on each restart), and given up once the time budget runs out. If no
+ *  sample was drawn in time, the scores are the sinkhorn ones (see
+ *  sinkhorn.h).
+ */
+
+#define DEFAULT_NUM_OF_SAMPLES (1000)
+#define DEFAULT_SAMPLE_MS (2000)
+
+/**
+ * Fills the scores of the board's empty cells with the frequencies of their
+ * values in random solutions. The get_marginals operation of the sampling
+ * backend.
+ * @param board: the board to get the scores for.
+ * @param scores: an array of dim^3 scores to fill, indexed as in backend.h.
+ * @return: true if the scores were filled, and false if the board has no
+ * solution.
+ */
+bool get_sampled_marginals(const Board *board, double *scores);
+
+#endif
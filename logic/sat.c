@@ -0,0 +1,271 @@
+#include <stdlib.h>
+#include "sat.h"
+#include "cdcl.h"
+#include "backtracking.h"
+#include "../MemoryError.h"
+
+#define NO_VARIABLE (-1)
+/* Groups of up to this many variables get pairwise "at most one" clauses,
+ * and larger groups a sequential counter */
+#define PAIRWISE_LIMIT (6)
+#define NUM_OF_UNIT_TYPES (3)
+
+/* The SAT encoding of a board */
+typedef struct {
+    SatSolver *solver;
+    int dim;
+    int num_of_empty;
+    int *vars;          /* the variable of each cell and value ([cell * dim + value - 1]), or NO_VARIABLE */
+    int *group;         /* a buffer for the variables of a constraint */
+} SatEncoding;
+
+
+/* Adds the clause of two literals. */
+bool add_binary_clause(SatSolver *solver, int first, int second) {
+    int literals[2];
+
+    literals[0] = first;
+    literals[1] = second;
+    return add_sat_clause(solver, literals, 2);
+}
+
+/* Adds the clauses that exactly one of the variables of the group is true. */
+bool add_exactly_one(SatSolver *solver, int *group, int size) {
+    int i, j, counter, previous_counter = NO_VARIABLE;
+
+    /* at least one (the group is reused for the clause's literals) */
+    for (i = 0; i < size; i++) {
+        group[i] = POSITIVE_LITERAL(group[i]);
+    }
+    if (!add_sat_clause(solver, group, size)) {
+        return false;
+    }
+    for (i = 0; i < size; i++) {
+        group[i] = LITERAL_VAR(group[i]);
+    }
+
+    /* at most one */
+    if (size <= PAIRWISE_LIMIT) {
+        for (i = 0; i < size; i++) {
+            for (j = i + 1; j < size; j++) {
+                if (!add_binary_clause(solver, NEGATIVE_LITERAL(group[i]), NEGATIVE_LITERAL(group[j]))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /* counter i is true if one of the first i + 1 variables is */
+    for (i = 0; i < size - 1; i++) {
+        counter = add_sat_variable(solver, false);
+        if (!add_binary_clause(solver, NEGATIVE_LITERAL(group[i]), POSITIVE_LITERAL(counter))) {
+            return false;
+        }
+        if (previous_counter != NO_VARIABLE &&
+            (!add_binary_clause(solver, NEGATIVE_LITERAL(previous_counter), POSITIVE_LITERAL(counter)) ||
+             !add_binary_clause(solver, NEGATIVE_LITERAL(group[i]), NEGATIVE_LITERAL(previous_counter)))) {
+            return false;
+        }
+        previous_counter = counter;
+    }
+    return add_binary_clause(solver, NEGATIVE_LITERAL(group[size - 1]), NEGATIVE_LITERAL(previous_counter));
+}
+
+/* Adds the constraints of the empty cells (each has exactly one value). */
+bool encode_cells(SatEncoding *encoding, const Board *board) {
+    int cell, value, size, dim = encoding->dim;
+
+    for (cell = 0; cell < dim * dim; cell++) {
+        if (!is_cell_empty(board, cell / dim, cell % dim)) {
+            continue;
+        }
+        size = 0;
+        for (value = 1; value <= dim; value++) {
+            if (encoding->vars[cell * dim + value - 1] != NO_VARIABLE) {
+                encoding->group[size] = encoding->vars[cell * dim + value - 1];
+                size++;
+            }
+        }
+        if (!add_exactly_one(encoding->solver, encoding->group, size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Adds the constraints of the units (each missing value appears exactly once). */
+bool encode_units(SatEncoding *encoding, const Board *board) {
+    int type, unit, i, value, cell, size, dim = encoding->dim;
+    const int *cells;
+    ValueSet used;
+
+    for (type = 0; type < NUM_OF_UNIT_TYPES; type++) {
+        for (unit = 0; unit < dim; unit++) {
+            cells = get_unit_cells(board, (UnitType) type, unit);
+            clear_value_set(&used);
+            for (i = 0; i < dim; i++) {
+                value = get_cell_value(board, cells[i] / dim, cells[i] % dim);
+                if (value != CLEAR) {
+                    add_value(&used, value);
+                }
+            }
+
+            for (value = 1; value <= dim; value++) {
+                if (contains_value(&used, value)) {
+                    continue;
+                }
+                size = 0;
+                for (i = 0; i < dim; i++) {
+                    cell = cells[i];
+                    if (encoding->vars[cell * dim + value - 1] != NO_VARIABLE) {
+                        encoding->group[size] = encoding->vars[cell * dim + value - 1];
+                        size++;
+                    }
+                }
+                if (!add_exactly_one(encoding->solver, encoding->group, size)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/* Creates the SAT encoding of the board. Its solver is unsatisfiable if the
+ * encoding already shows that the board has no solution. */
+SatEncoding* create_sat_encoding(const Board *board) {
+    int cell, value, dim = board->dim;
+    ValueSet candidates;
+    SatEncoding *encoding = malloc(sizeof(SatEncoding));
+    validate_memory_allocation("create_sat_encoding", encoding);
+
+    encoding->solver = create_sat_solver();
+    encoding->dim = dim;
+    encoding->num_of_empty = 0;
+    encoding->vars = malloc(dim * dim * dim * sizeof(int));
+    validate_memory_allocation("create_sat_encoding", encoding->vars);
+    encoding->group = malloc(dim * sizeof(int));
+    validate_memory_allocation("create_sat_encoding", encoding->group);
+
+    for (cell = 0; cell < dim * dim; cell++) {
+        for (value = 1; value <= dim; value++) {
+            encoding->vars[cell * dim + value - 1] = NO_VARIABLE;
+        }
+        if (!is_cell_empty(board, cell / dim, cell % dim)) {
+            continue;
+        }
+        encoding->num_of_empty++;
+        get_cell_candidates(board, &candidates, cell / dim, cell % dim);
+        for (value = get_next_value(&candidates, CLEAR); value != CLEAR; value = get_next_value(&candidates, value)) {
+            encoding->vars[cell * dim + value - 1] = add_sat_variable(encoding->solver, true);
+        }
+    }
+
+    if (is_board_erroneous(board) || !encode_cells(encoding, board) || !encode_units(encoding, board)) {
+        encoding->solver->unsatisfiable = true;
+    }
+    return encoding;
+}
+
+void destroy_sat_encoding(SatEncoding *encoding) {
+    destroy_sat_solver(encoding->solver);
+    free(encoding->vars);
+    free(encoding->group);
+    free(encoding);
+}
+
+/* Gets the value of the cell in the solver's model. */
+int get_model_cell_value(const SatEncoding *encoding, int cell) {
+    int value, var;
+
+    for (value = 1; value <= encoding->dim; value++) {
+        var = encoding->vars[cell * encoding->dim + value - 1];
+        if (var != NO_VARIABLE && encoding->solver->model[var]) {
+            return value;
+        }
+    }
+    return CLEAR;
+}
+
+/* Excludes the solution in the solver's model (at least one empty cell must
+ * get another value). Returns false if no other solution is left. */
+bool exclude_model(SatEncoding *encoding, const Board *board) {
+    int cell, size = 0, dim = encoding->dim, value;
+    bool excluded;
+    int *literals = malloc((encoding->num_of_empty + 1) * sizeof(int));
+    validate_memory_allocation("exclude_model", literals);
+
+    for (cell = 0; cell < dim * dim; cell++) {
+        if (is_cell_empty(board, cell / dim, cell % dim)) {
+            value = get_model_cell_value(encoding, cell);
+            literals[size] = NEGATIVE_LITERAL(encoding->vars[cell * dim + value - 1]);
+            size++;
+        }
+    }
+    excluded = add_sat_clause(encoding->solver, literals, size);
+    free(literals);
+    return excluded;
+}
+
+bool find_sat_solution(Board *board) {
+    int cell, dim = board->dim;
+    bool solved;
+    SatEncoding *encoding = create_sat_encoding(board);
+    Board *solution;
+
+    if (!solve_sat(encoding->solver)) {
+        destroy_sat_encoding(encoding);
+        return false;
+    }
+
+    /* fill a copy, so the board is left unchanged if the solution is invalid */
+    solution = get_board_copy(board);
+    for (cell = 0; cell < dim * dim; cell++) {
+        if (is_cell_empty(board, cell / dim, cell % dim)) {
+            set_cell_value(solution, cell / dim, cell % dim, get_model_cell_value(encoding, cell));
+        }
+    }
+    destroy_sat_encoding(encoding);
+
+    solved = !is_board_erroneous(solution) && solution->empty_count == 0;
+    if (solved) {
+        restore_board(board, solution);
+    }
+    destroy_board(solution);
+    return solved;
+}
+
+void count_sat_solutions(const Board *board, uint64_t limit, Count *counter, unsigned long *num_of_nodes) {
+    uint64_t num_of_solutions = 0;
+    SatEncoding *encoding;
+
+    if (limit == NO_SOLUTIONS_LIMIT) {
+        get_num_of_solutions(board, limit, counter, num_of_nodes);
+        return;
+    }
+
+    encoding = create_sat_encoding(board);
+    while (num_of_solutions < limit && solve_sat(encoding->solver)) {
+        num_of_solutions++;
+        if (!exclude_model(encoding, board)) {
+            break;
+        }
+    }
+    set_count_value(counter, num_of_solutions);
+    if (num_of_nodes != NULL) {
+        *num_of_nodes = encoding->solver->num_of_decisions;
+    }
+    destroy_sat_encoding(encoding);
+}
+
+bool is_unique_sat(const Board *board) {
+    Count counter;
+    bool unique;
+
+    init_count(&counter);
+    count_sat_solutions(board, 2, &counter, NULL);
+    unique = !is_count_at_least(&counter, 2) && is_count_at_least(&counter, 1);
+    free_count(&counter);
+    return unique;
+}
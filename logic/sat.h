@@ -0,0 +1,52 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include "../components/Board.h"
+#include "../components/Count.h"
+
+#ifndef FINAL_PROJECT_SAT_H
+#define FINAL_PROJECT_SAT_H
+
+/** sat:
+ *
+ *  Solves boards as SAT problems, with the in-tree CDCL solver (see cdcl.h).
+ *  The encoding has a variable for each empty cell and legal value, and the
+ *  same constraints as the ILP model (see solver.c): each empty cell has
+ *  exactly one value, and each value that's missing from a row, column or
+ *  block appears in exactly one of its empty cells. Each "exactly one" is a
+ *  clause of all the variables (at least one), and pairwise exclusions for
+ *  small groups or a sequential counter for larger ones (at most one, with a
+ *  linear number of clauses).
+ *  Clause learning handles large boards (e.g. 8x8 blocks) that make
+ *  chronological backtracking thrash.
+ */
+
+/**
+ * Fills the empty cells of the board with a solution, if it has one.
+ * @param board: the board to solve. Left unchanged if it can't be solved.
+ * @return: true if the board was solved, and false if it has no solution.
+ */
+bool find_sat_solution(Board *board);
+
+/**
+ * Counts the solutions of the board, up to the limit, by finding them one by
+ * one: each solution is excluded with a clause before searching for the next.
+ * This only suits small limits (e.g. checking uniqueness), so counting all
+ * the solutions is left to the backtracking counter (get_num_of_solutions).
+ * @param board: the board to get the number of solutions for.
+ * @param limit: the number of solutions to stop the search at, or
+ * NO_SOLUTIONS_LIMIT (see backtracking.h) to count all of them.
+ * @param counter: an initialized count, set to the number of solutions.
+ * @param num_of_nodes: pointer to be updated with the number of decisions the
+ * search made (may be NULL).
+ */
+void count_sat_solutions(const Board *board, uint64_t limit, Count *counter, unsigned long *num_of_nodes);
+
+/**
+ * Checks if the board has exactly one solution, using the SAT solver. The
+ * is_unique operation of the sat backend.
+ * @param board: the board to check.
+ * @return: true if the board has a single solution, and false otherwise.
+ */
+bool is_unique_sat(const Board *board);
+
+#endif
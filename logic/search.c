@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include "search.h"
+#include "../MemoryError.h"
+
+#define NOT_EMPTY (-1)
+
+
+Search* create_search(Board *board) {
+    int row, column, cell, N = board->dim;
+    Search *search = malloc(sizeof(Search));
+    validate_memory_allocation("create_search", search);
+
+    search->board = board;
+    search->empty_cells = malloc(N * N * sizeof(int));
+    validate_memory_allocation("create_search", search->empty_cells);
+    search->positions = malloc(N * N * sizeof(int));
+    validate_memory_allocation("create_search", search->positions);
+    search->_candidates = malloc(N * N * sizeof(ValueSet));
+    validate_memory_allocation("create_search", search->_candidates);
+    search->num_of_empty = 0;
+    search->depth = 0;
+    search->num_of_nodes = 0;
+
+    for (row = 0; row < N; row++) {
+        for (column = 0; column < N; column++) {
+            cell = row * N + column;
+            if (is_cell_empty(board, row, column)) {
+                search->positions[cell] = search->num_of_empty;
+                search->empty_cells[search->num_of_empty++] = cell;
+            } else {
+                search->positions[cell] = NOT_EMPTY;
+            }
+        }
+    }
+    return search;
+}
+
+void destroy_search(Search *search) {
+    if (search == NULL) {
+        return;
+    }
+
+    free(search->empty_cells);
+    free(search->positions);
+    free(search->_candidates);
+    free(search);
+}
+
+/* Swaps the cells at the given positions of empty_cells. */
+void swap_empty_cells(Search *search, int i, int j) {
+    int cell = search->empty_cells[i];
+
+    search->empty_cells[i] = search->empty_cells[j];
+    search->empty_cells[j] = cell;
+    search->positions[search->empty_cells[i]] = i;
+    search->positions[cell] = j;
+}
+
+void assign_cell(Search *search, int cell, int value) {
+    int N = search->board->dim;
+
+    swap_empty_cells(search, search->positions[cell], search->depth);
+    search->depth++;
+    set_cell_value(search->board, cell / N, cell % N, value);
+}
+
+int select_most_constrained_cell(Search *search) {
+    int i, count, best = search->depth, best_count = search->board->dim + 1, cell, N = search->board->dim;
+    ValueSet candidates;
+
+    for (i = search->depth; i < search->num_of_empty; i++) {
+        cell = search->empty_cells[i];
+        get_cell_candidates(search->board, &candidates, cell / N, cell % N);
+        count = count_values(&candidates);
+
+        if (count < best_count) {
+            best = i;
+            best_count = count;
+            if (count <= 1) { /* a dead end or a forced cell, can't do better */
+                break;
+            }
+        }
+    }
+
+    swap_empty_cells(search, best, search->depth);
+    return best_count;
+}
+
+/* Assigns all the unassigned cells that have a single legal value, and keeps
+ * the legal values of the others. Returns the number of assigned cells, or
+ * ERROR_VALUE if some cell has no legal value. */
+int assign_naked_singles(Search *search) {
+    int i, cell, count, num_of_assigned = 0, N = search->board->dim;
+    ValueSet *candidates;
+
+    /* assigning swaps an already visited cell into position i */
+    for (i = search->depth; i < search->num_of_empty; i++) {
+        cell = search->empty_cells[i];
+        candidates = &search->_candidates[cell];
+        get_cell_candidates(search->board, candidates, cell / N, cell % N);
+        count = count_values(candidates);
+
+        if (count == 0) {
+            return ERROR_VALUE;
+        }
+        if (count == 1) {
+            assign_cell(search, cell, get_next_value(candidates, CLEAR));
+            num_of_assigned++;
+        }
+    }
+    return num_of_assigned;
+}
+
+/* Assigns each value that fits in a single empty cell of the given unit to
+ * that cell. Returns the number of assigned cells, or ERROR_VALUE if some
+ * value that's missing from the unit doesn't fit in any of its cells.
+ * Uses the legal values kept by assign_naked_singles: cells assigned since
+ * then only removed legal values, so the kept ones are a superset, which
+ * can only hide singles (found on the next pass), not make up wrong ones. */
+int assign_hidden_singles(Search *search, UnitType type, int unit) {
+    int i, cell, value, num_of_assigned = 0, N = search->board->dim;
+    const int *cells = get_unit_cells(search->board, type, unit);
+    const ValueSet *candidates;
+    ValueSet once, twice, missing;
+    unsigned int k;
+
+    /* once/twice: the values that fit in at least one/two of the empty cells */
+    clear_value_set(&once);
+    clear_value_set(&twice);
+    fill_value_set(&missing, N);
+    for (i = 0; i < N; i++) {
+        value = get_cell_value(search->board, cells[i] / N, cells[i] % N);
+        if (value != CLEAR) {
+            remove_value(&missing, value);
+            continue;
+        }
+        candidates = &search->_candidates[cells[i]];
+        for (k = 0; k < VALUE_SET_WORDS; k++) {
+            twice.words[k] |= once.words[k] & candidates->words[k];
+        }
+        add_value_set(&once, candidates);
+    }
+
+    for (k = 0; k < VALUE_SET_WORDS; k++) {
+        if ((missing.words[k] & ~once.words[k]) != 0) {
+            return ERROR_VALUE;
+        }
+        once.words[k] &= ~twice.words[k]; /* the values with a single place */
+    }
+
+    for (value = get_next_value(&once, CLEAR); value != CLEAR; value = get_next_value(&once, value)) {
+        for (i = 0; i < N; i++) {
+            cell = cells[i];
+            /* an earlier assignment may have taken the value's only place */
+            if (is_cell_empty(search->board, cell / N, cell % N)
+                && is_legal_value(search->board, cell / N, cell % N, value)) {
+                assign_cell(search, cell, value);
+                num_of_assigned++;
+                break;
+            }
+        }
+    }
+    return num_of_assigned;
+}
+
+bool propagate(Search *search) {
+    int type, unit, num_of_assigned = 1, result;
+
+    while (num_of_assigned > 0 && search->depth < search->num_of_empty) {
+        num_of_assigned = assign_naked_singles(search);
+        if (num_of_assigned == ERROR_VALUE) {
+            return false;
+        }
+        if (num_of_assigned > 0) {
+            continue; /* the unit scans are costlier, so only run them once no naked single is left */
+        }
+
+        for (type = row_unit; type <= block_unit; type++) {
+            for (unit = 0; unit < search->board->dim; unit++) {
+                result = assign_hidden_singles(search, (UnitType) type, unit);
+                if (result == ERROR_VALUE) {
+                    return false;
+                }
+                num_of_assigned += result;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#include "../components/Board.h"
+
+#ifndef FINAL_PROJECT_SEARCH_H
+#define FINAL_PROJECT_SEARCH_H
+
+/** Search:
+ *
+ *  The state shared by the exhaustive searches over a board (counting and
+ *  solving): the board that is searched in place, and the cells that were
+ *  empty when the search started, kept so the assigned ones come first.
+ *  The module also implements the search's constraint propagation (naked
+ *  and hidden singles). All changes are made through set_cell_value, so they
+ *  are undone with the board's trail (see push_level and pop_level), after
+ *  which the caller restores the depth it saved.
+ */
+
+typedef struct {
+    Board *board;
+    int *empty_cells;           /* the cells that were empty when the search was created: [0..depth) are assigned */
+    int *positions;             /* the position of each cell in empty_cells (by cell index, -1 if it wasn't empty) */
+    int num_of_empty;
+    int depth;                  /* the number of assigned cells */
+    unsigned long num_of_nodes; /* the number of decisions made so far (for measuring the search) */
+    ValueSet *_candidates;      /* the legal values of each cell (by cell index), as of the last propagation pass */
+} Search;
+
+/**
+ * Creates a new search over the given board, starting from its current state
+ * (depth 0).
+ * @param board: the board to search in place.
+ * @return: the new search that was created.
+ */
+Search* create_search(Board *board);
+
+/**
+ * Destroys the given search (frees all related memory). The board isn't
+ * destroyed.
+ * @param search: the search to destroy.
+ */
+void destroy_search(Search *search);
+
+/**
+ * Assigns a value to an empty cell of the search, and moves the cell to the
+ * end of the assigned cells (increases the depth).
+ * @param search: the search to update.
+ * @param cell: the index of the cell (row * dim + column). Must be unassigned.
+ * @param value: the value to assign.
+ */
+void assign_cell(Search *search, int cell, int value);
+
+/**
+ * Finds the unassigned cell with the fewest legal values (the most
+ * constrained one), and moves it to empty_cells[depth].
+ * @param search: the search to update. Must have unassigned cells.
+ * @return: the number of legal values of the selected cell (0 means the board
+ * can't be completed).
+ */
+int select_most_constrained_cell(Search *search);
+
+/**
+ * Propagates the constraints of the board until nothing more can be deduced:
+ * assigns every cell that has a single legal value (naked single), and every
+ * value that fits in a single cell of some row, column or block (hidden
+ * single). Stops at the first cell that has no legal values, or unit value
+ * that has no cell left.
+ * @param search: the search to update.
+ * @return: false if the board was found to be unsolvable, and true otherwise.
+ */
+bool propagate(Search *search);
+
+#endif
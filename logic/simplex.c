@@ -0,0 +1,448 @@
+#include <stdlib.h>
+#include "simplex.h"
+#include "sinkhorn.h"
+#include "random.h"
+#include "../MemoryError.h"
+
+#define NUM_OF_CONSTRAINT_TYPES (4)
+#define NOT_NEEDED (-1)
+#define NO_INDEX (-1)
+/* The objective coefficients are drawn from [0, dim * dim * RANGE_CONST), as
+ * in the gurobi LP */
+#define RANGE_CONST (10)
+/* Entries this close to 0 are rounded to 0 */
+#define EPSILON (1e-9)
+/* The tolerance for rounding errors: the smallest entry that's pivoted on
+ * (smaller ones are numerically unstable), the smallest negative reduced cost
+ * that's improved on, and the largest step that counts as degenerate */
+#define TOLERANCE (1e-7)
+/* The largest infeasibility (sum of the artificial variables) that's accepted
+ * as feasible at the end of phase one */
+#define FEASIBILITY_TOLERANCE (1e-6)
+/* The number of consecutive degenerate pivots that switches to Bland's rule */
+#define DEGENERATE_LIMIT (50)
+/* The pivots allowed per row and column, before the solve is given up */
+#define PIVOTS_FACTOR (50)
+/* The largest tableau that's solved (in entries, 32MB), and the most entries
+ * all the pivots together may update. A pivot updates the whole tableau, so
+ * larger LPs take too long (and too much memory) for a dense tableau */
+#define MAX_TABLEAU_ENTRIES (1L << 22)
+#define MAX_PIVOT_ENTRIES (2e9)
+
+/* Below any objective value (so phase two runs to the optimum) */
+#define HUGE_OBJECTIVE (1e30)
+
+#define ABS(x) (((x) < 0) ? -(x) : (x))
+
+/* A dense simplex tableau in standard form. Each row is a constraint, with its
+ * right hand side (the value of its basic variable) last. The artificial
+ * variable of row r is numbered num_of_columns + r, and has no column. */
+typedef struct {
+    int num_of_rows;
+    int num_of_columns;
+    int width;              /* num_of_columns + 1 */
+    double *tableau;        /* [row * width + column] */
+    double *costs;          /* the reduced costs, with minus the objective value last */
+    double *objective;      /* the objective coefficient of each column */
+    int *basis;             /* the basic variable of each row */
+    int *scores;            /* the score index of each column ([cell * dim + value - 1]) */
+    int *nonzeros;          /* a buffer for the nonzero columns of the pivot row */
+    long num_of_pivots;     /* the pivots made so far, in both phases */
+    long max_pivots;        /* the pivots allowed, before the solve is given up */
+} SimplexTableau;
+
+/* The outcome of running the simplex method */
+typedef enum {
+    simplex_optimal,
+    simplex_infeasible,     /* (phase one) or unbounded */
+    simplex_failed          /* the pivots ran out */
+} SimplexStatus;
+
+
+/* Maps each constraint to its tableau row, or NOT_NEEDED if the filled cells
+ * already satisfy it. The constraints are indexed as in dlx.c: by type (cell,
+ * row, column, block), and then by [cell] or by [unit * dim + value - 1].
+ * Returns the number of rows. */
+int map_constraint_rows(const Board *board, int *rows) {
+    int row, column, value, block, i, dim = board->dim, num_of_rows = 0;
+
+    for (i = 0; i < NUM_OF_CONSTRAINT_TYPES * dim * dim; i++) {
+        rows[i] = 0;
+    }
+    for (row = 0; row < dim; row++) {
+        for (column = 0; column < dim; column++) {
+            value = get_cell_value(board, row, column);
+            if (value == CLEAR) {
+                continue;
+            }
+            block = get_block_index(board, row, column);
+            rows[row * dim + column] = NOT_NEEDED;
+            rows[dim * dim + row * dim + value - 1] = NOT_NEEDED;
+            rows[2 * dim * dim + column * dim + value - 1] = NOT_NEEDED;
+            rows[3 * dim * dim + block * dim + value - 1] = NOT_NEEDED;
+        }
+    }
+
+    for (i = 0; i < NUM_OF_CONSTRAINT_TYPES * dim * dim; i++) {
+        if (rows[i] != NOT_NEEDED) {
+            rows[i] = num_of_rows++;
+        }
+    }
+    return num_of_rows;
+}
+
+/* Counts the variables of the board (its empty cells' legal values). Returns
+ * NO_INDEX if an empty cell has no legal value. */
+int count_simplex_columns(const Board *board) {
+    int row, column, num_of_values, num_of_columns = 0;
+    ValueSet candidates;
+
+    for (row = 0; row < board->dim; row++) {
+        for (column = 0; column < board->dim; column++) {
+            if (!is_cell_empty(board, row, column)) {
+                continue;
+            }
+            get_cell_candidates(board, &candidates, row, column);
+            num_of_values = count_values(&candidates);
+            if (num_of_values == 0) {
+                return NO_INDEX;
+            }
+            num_of_columns += num_of_values;
+        }
+    }
+    return num_of_columns;
+}
+
+/* Creates the tableau of the board's LP, with the artificial variables as the
+ * initial basis. */
+SimplexTableau* create_simplex_tableau(const Board *board, int num_of_columns) {
+    int row, column, value, block, i, index = 0, dim = board->dim;
+    int *rows;
+    double *entries;
+    ValueSet candidates;
+    SimplexTableau *simplex = malloc(sizeof(SimplexTableau));
+    validate_memory_allocation("create_simplex_tableau", simplex);
+
+    rows = malloc(NUM_OF_CONSTRAINT_TYPES * dim * dim * sizeof(int));
+    validate_memory_allocation("create_simplex_tableau", rows);
+    simplex->num_of_rows = map_constraint_rows(board, rows);
+    simplex->num_of_columns = num_of_columns;
+    simplex->width = num_of_columns + 1;
+
+    simplex->tableau = calloc((size_t) simplex->num_of_rows * simplex->width, sizeof(double));
+    validate_memory_allocation("create_simplex_tableau", simplex->tableau);
+    simplex->costs = malloc(simplex->width * sizeof(double));
+    validate_memory_allocation("create_simplex_tableau", simplex->costs);
+    simplex->objective = malloc(num_of_columns * sizeof(double));
+    validate_memory_allocation("create_simplex_tableau", simplex->objective);
+    simplex->basis = malloc(simplex->num_of_rows * sizeof(int));
+    validate_memory_allocation("create_simplex_tableau", simplex->basis);
+    simplex->scores = malloc(num_of_columns * sizeof(int));
+    validate_memory_allocation("create_simplex_tableau", simplex->scores);
+    simplex->nonzeros = malloc(simplex->width * sizeof(int));
+    validate_memory_allocation("create_simplex_tableau", simplex->nonzeros);
+
+    for (row = 0; row < dim; row++) {
+        for (column = 0; column < dim; column++) {
+            if (!is_cell_empty(board, row, column)) {
+                continue;
+            }
+            block = get_block_index(board, row, column);
+            get_cell_candidates(board, &candidates, row, column);
+            for (value = get_next_value(&candidates, CLEAR); value != CLEAR;
+                 value = get_next_value(&candidates, value)) {
+                entries = simplex->tableau + index;
+                entries[rows[row * dim + column] * simplex->width] = 1.0;
+                entries[rows[dim * dim + row * dim + value - 1] * simplex->width] = 1.0;
+                entries[rows[2 * dim * dim + column * dim + value - 1] * simplex->width] = 1.0;
+                entries[rows[3 * dim * dim + block * dim + value - 1] * simplex->width] = 1.0;
+                simplex->objective[index] = get_rand_index(dim * dim * RANGE_CONST);
+                simplex->scores[index] = (row * dim + column) * dim + value - 1;
+                index++;
+            }
+        }
+    }
+    free(rows);
+
+    for (i = 0; i < simplex->num_of_rows; i++) {
+        simplex->tableau[i * simplex->width + num_of_columns] = 1.0;
+        simplex->basis[i] = num_of_columns + i;
+    }
+    simplex->num_of_pivots = 0;
+    simplex->max_pivots = (long) PIVOTS_FACTOR * (simplex->num_of_rows + num_of_columns);
+    if (simplex->max_pivots > MAX_PIVOT_ENTRIES / ((double) simplex->num_of_rows * simplex->width)) {
+        simplex->max_pivots = (long) (MAX_PIVOT_ENTRIES / ((double) simplex->num_of_rows * simplex->width));
+    }
+    return simplex;
+}
+
+void destroy_simplex_tableau(SimplexTableau *simplex) {
+    free(simplex->tableau);
+    free(simplex->costs);
+    free(simplex->objective);
+    free(simplex->basis);
+    free(simplex->scores);
+    free(simplex->nonzeros);
+    free(simplex);
+}
+
+/* Subtracts factor times the pivot row from the target row. Sparse pivot
+ * rows only visit their nonzero columns, and dense ones are subtracted whole
+ * (which the compiler can vectorize). */
+void eliminate_simplex_row(double *target, const double *pivot_row, const int *nonzeros, int num_of_nonzeros,
+                           int width, double factor) {
+    int k, column;
+
+    if (2 * num_of_nonzeros > width) {
+        for (column = 0; column < width; column++) {
+            target[column] -= factor * pivot_row[column];
+        }
+        return;
+    }
+    for (k = 0; k < num_of_nonzeros; k++) {
+        column = nonzeros[k];
+        target[column] -= factor * pivot_row[column];
+    }
+}
+
+/* Makes the column basic in the row: scales the row so the column's entry is
+ * 1, and eliminates the column from the other rows and the reduced costs. */
+void pivot_simplex(SimplexTableau *simplex, int pivot, int column) {
+    int row, j, num_of_nonzeros = 0, width = simplex->width;
+    double *pivot_row = simplex->tableau + (size_t) pivot * width, *target;
+    double inverse = 1.0 / pivot_row[column];
+
+    /* entries that are only rounding errors are dropped, so they don't spread */
+    for (j = 0; j < width; j++) {
+        pivot_row[j] *= inverse;
+        if (ABS(pivot_row[j]) < EPSILON) {
+            pivot_row[j] = 0.0;
+        } else {
+            simplex->nonzeros[num_of_nonzeros++] = j;
+        }
+    }
+    pivot_row[column] = 1.0;
+
+    for (row = 0; row < simplex->num_of_rows; row++) {
+        target = simplex->tableau + (size_t) row * width;
+        if (row != pivot && target[column] != 0.0) {
+            eliminate_simplex_row(target, pivot_row, simplex->nonzeros, num_of_nonzeros, width, target[column]);
+            target[column] = 0.0;
+            /* rounding can leave values slightly below 0 */
+            if (target[simplex->num_of_columns] < 0.0) {
+                target[simplex->num_of_columns] = 0.0;
+            }
+        }
+    }
+    if (simplex->costs[column] != 0.0) {
+        eliminate_simplex_row(simplex->costs, pivot_row, simplex->nonzeros, num_of_nonzeros, width,
+                              simplex->costs[column]);
+        simplex->costs[column] = 0.0;
+    }
+    simplex->basis[pivot] = column;
+}
+
+/* Chooses the column to enter the basis: the one with the most negative
+ * reduced cost, or the first negative one by Bland's rule. Returns NO_INDEX if
+ * the basis is optimal. */
+int choose_entering_column(const SimplexTableau *simplex, bool bland) {
+    int j, entering = NO_INDEX;
+
+    for (j = 0; j < simplex->num_of_columns; j++) {
+        if (simplex->costs[j] < -TOLERANCE && (entering == NO_INDEX || simplex->costs[j] < simplex->costs[entering])) {
+            entering = j;
+            if (bland) {
+                break;
+            }
+        }
+    }
+    return entering;
+}
+
+/* Chooses the row to leave the basis when the column enters it, by a two
+ * pass ratio test: the rows whose ratio is within the rounding tolerance of
+ * the minimum are candidates, and the one with the largest entry is chosen
+ * (the most stable pivot), or the smallest basic variable by Bland's rule.
+ * Returns NO_INDEX if the column can grow without a bound. */
+int choose_leaving_row(const SimplexTableau *simplex, int column, bool bland) {
+    int row, leaving = NO_INDEX, width = simplex->width, rhs = simplex->num_of_columns;
+    double entry, bound = 0.0;
+    const double *values;
+
+    for (row = 0; row < simplex->num_of_rows; row++) {
+        values = simplex->tableau + (size_t) row * width;
+        entry = values[column];
+        if (entry > TOLERANCE && (leaving == NO_INDEX || (values[rhs] + EPSILON) / entry < bound)) {
+            bound = (values[rhs] + EPSILON) / entry;
+            leaving = row;
+        }
+    }
+    if (leaving == NO_INDEX) {
+        return NO_INDEX;
+    }
+
+    for (row = 0; row < simplex->num_of_rows; row++) {
+        values = simplex->tableau + (size_t) row * width;
+        entry = values[column];
+        if (entry <= TOLERANCE || values[rhs] / entry > bound) {
+            continue;
+        }
+        if (bland ? (simplex->basis[row] < simplex->basis[leaving])
+                  : (entry > simplex->tableau[(size_t) leaving * width + column])) {
+            leaving = row;
+        }
+    }
+    return leaving;
+}
+
+/* Pivots until the reduced costs show the basis is optimal, or until the
+ * objective reaches the target. Returns simplex_infeasible if the LP is
+ * unbounded, and simplex_failed if the pivots ran out. */
+SimplexStatus run_simplex(SimplexTableau *simplex, double target) {
+    int entering, leaving, num_of_degenerate = 0;
+    bool bland;
+
+    while (simplex->num_of_pivots < simplex->max_pivots) {
+        bland = num_of_degenerate >= DEGENERATE_LIMIT;
+        entering = choose_entering_column(simplex, bland);
+        if (entering == NO_INDEX || -simplex->costs[simplex->num_of_columns] <= target) {
+            return simplex_optimal;
+        }
+        leaving = choose_leaving_row(simplex, entering, bland);
+        if (leaving == NO_INDEX) {
+            return simplex_infeasible;
+        }
+        if (simplex->tableau[(size_t) leaving * simplex->width + simplex->num_of_columns] <= TOLERANCE) {
+            num_of_degenerate++;
+        } else {
+            num_of_degenerate = 0;
+        }
+        pivot_simplex(simplex, leaving, entering);
+        simplex->num_of_pivots++;
+    }
+    return simplex_failed;
+}
+
+/* Phase one: minimizes the sum of the artificial variables. Returns
+ * simplex_infeasible if it can't reach 0. */
+SimplexStatus find_feasible_basis(SimplexTableau *simplex) {
+    int row, j, width = simplex->width;
+    SimplexStatus status;
+
+    for (j = 0; j < width; j++) {
+        simplex->costs[j] = 0.0;
+    }
+    for (row = 0; row < simplex->num_of_rows; row++) {
+        for (j = 0; j < width; j++) {
+            simplex->costs[j] -= simplex->tableau[(size_t) row * width + j];
+        }
+    }
+    status = run_simplex(simplex, FEASIBILITY_TOLERANCE);
+    if (status == simplex_optimal && -simplex->costs[simplex->num_of_columns] > FEASIBILITY_TOLERANCE) {
+        return simplex_infeasible;
+    }
+    return status;
+}
+
+/* Pivots the artificial variables that are still basic (at 0, up to the
+ * feasibility tolerance) out of the basis, on the largest entry of their row.
+ * A row whose artificial variable can't leave is a redundant constraint: it's
+ * all (nearly) zeros, so it never takes part in a pivot again. */
+void drive_out_artificials(SimplexTableau *simplex) {
+    int row, j, largest;
+    double *values;
+
+    for (row = 0; row < simplex->num_of_rows; row++) {
+        if (simplex->basis[row] < simplex->num_of_columns) {
+            continue;
+        }
+        values = simplex->tableau + (size_t) row * simplex->width;
+        largest = 0;
+        for (j = 1; j < simplex->num_of_columns; j++) {
+            if (ABS(values[j]) > ABS(values[largest])) {
+                largest = j;
+            }
+        }
+        values[simplex->num_of_columns] = 0.0;
+        if (ABS(values[largest]) > TOLERANCE) {
+            pivot_simplex(simplex, row, largest);
+        }
+    }
+}
+
+/* Phase two: minimizes the objective from the feasible basis. */
+SimplexStatus optimize_simplex(SimplexTableau *simplex) {
+    int row, j, basic, width = simplex->width;
+    double coefficient;
+    SimplexStatus status;
+
+    for (j = 0; j < simplex->num_of_columns; j++) {
+        simplex->costs[j] = simplex->objective[j];
+    }
+    simplex->costs[simplex->num_of_columns] = 0.0;
+    for (row = 0; row < simplex->num_of_rows; row++) {
+        basic = simplex->basis[row];
+        if (basic >= simplex->num_of_columns) {
+            continue;
+        }
+        coefficient = simplex->objective[basic];
+        for (j = 0; j < width; j++) {
+            simplex->costs[j] -= coefficient * simplex->tableau[(size_t) row * width + j];
+        }
+    }
+    /* the variables are bounded, so an unbounded LP here is numerical trouble */
+    status = run_simplex(simplex, -HUGE_OBJECTIVE);
+    return (status == simplex_infeasible) ? simplex_failed : status;
+}
+
+/* Bounds the size of the board's tableau (in entries): a cell row per empty
+ * cell, and at most a row per value of every row, column and block. */
+double get_simplex_tableau_size(const Board *board, int num_of_columns) {
+    return (double) (board->empty_count + (NUM_OF_CONSTRAINT_TYPES - 1) * board->dim * board->dim) *
+           (num_of_columns + 1);
+}
+
+bool get_simplex_marginals(const Board *board, double *scores) {
+    int i, row, dim = board->dim, num_of_columns = count_simplex_columns(board);
+    double value;
+    SimplexStatus status;
+    SimplexTableau *simplex;
+
+    if (num_of_columns == NO_INDEX) {
+        return false;
+    }
+    for (i = 0; i < dim * dim * dim; i++) {
+        scores[i] = 0.0;
+    }
+    /* if no vars are needed, the board is either solved or is unsolvable */
+    if (num_of_columns == 0) {
+        return !is_board_erroneous(board) && board->empty_count == 0;
+    }
+
+    /* too large for a dense tableau */
+    if (get_simplex_tableau_size(board, num_of_columns) > MAX_TABLEAU_ENTRIES) {
+        return get_sinkhorn_marginals(board, scores);
+    }
+
+    simplex = create_simplex_tableau(board, num_of_columns);
+    status = find_feasible_basis(simplex);
+    if (status == simplex_optimal) {
+        drive_out_artificials(simplex);
+        status = optimize_simplex(simplex);
+    }
+    if (status != simplex_optimal) {
+        destroy_simplex_tableau(simplex);
+        /* a solve that ran out of pivots says nothing about the board */
+        return (status == simplex_failed) ? get_sinkhorn_marginals(board, scores) : false;
+    }
+
+    for (row = 0; row < simplex->num_of_rows; row++) {
+        if (simplex->basis[row] < num_of_columns) {
+            value = simplex->tableau[(size_t) row * simplex->width + num_of_columns];
+            /* basic variables at 0 can be left with rounding noise */
+            scores[simplex->scores[simplex->basis[row]]] = (value < EPSILON) ? 0.0 : (value > 1.0) ? 1.0 : value;
+        }
+    }
+    destroy_simplex_tableau(simplex);
+    return true;
+}
@@ -0,0 +1,44 @@
+#include <stdbool.h>
+#include "../components/Board.h"
+
+#ifndef FINAL_PROJECT_SIMPLEX_H
+#define FINAL_PROJECT_SIMPLEX_H
+
+/** simplex:
+ *
+ *  Solves the LP relaxation of a board with an in-tree simplex method, so
+ *  guessing needs no external solver. The model is the one the gurobi backend
+ *  builds (see solver.c): a variable for each empty cell and legal value,
+ *  with the same randomized objective, and an equality constraint (= 1) for
+ *  each empty cell and for each value that's missing from a row, column or
+ *  block. Every variable is in a cell constraint, so its upper bound of 1 is
+ *  implied, and the LP is solved in standard form (x >= 0).
+ *  It's a two phase tableau simplex: phase one finds a feasible basis from
+ *  artificial variables (which are never stored as columns, since they never
+ *  re-enter the basis), and phase two minimizes the objective from it.
+ *  The entering variable is the one with the most negative reduced cost, and
+ *  the leaving one is chosen by a two pass (Harris) ratio test that prefers
+ *  large pivots, for numerical stability. Both fall back to Bland's rule on
+ *  long runs of degenerate pivots (which are common here), so the method
+ *  can't cycle.
+ *  The tableau is dense (rows * variables doubles), and every pivot updates
+ *  all of it: 9x9 puzzles take milliseconds (an empty 9x9 board a fraction of
+ *  a second), but the work grows as dim^5. So a tableau of more than about
+ *  4M entries (an empty 16x16 board) isn't built, and the pivots are capped by
+ *  the entries they update; in both cases the scores are the sinkhorn ones
+ *  instead (see sinkhorn.h), so large boards still get an answer quickly.
+ */
+
+/**
+ * Fills the scores of the board's empty cells with an optimal solution of the
+ * LP relaxation. The get_marginals operation of the simplex backend.
+ * @param board: the board to get the scores for.
+ * @param scores: an array of dim^3 scores to fill, indexed as in backend.h
+ * (0 for the values that have no variable).
+ * @return: true if the scores were filled (by the simplex method or the
+ * sinkhorn fallback), and false if the relaxation is infeasible (so the board
+ * has no solution).
+ */
+bool get_simplex_marginals(const Board *board, double *scores);
+
+#endif
@@ -0,0 +1,165 @@
+#include <stdlib.h>
+#include "sinkhorn.h"
+#include "../MemoryError.h"
+
+#define TOLERANCE_ENV_VAR "SUDOKU_SINKHORN_TOLERANCE"
+#define ITERATIONS_ENV_VAR "SUDOKU_SINKHORN_ITERATIONS"
+#define NUM_OF_UNIT_TYPES (3)
+
+#define ABS(x) (((x) < 0) ? -(x) : (x))
+
+
+/* Gets the convergence tolerance (SUDOKU_SINKHORN_TOLERANCE if it's set to a
+ * positive number). */
+double get_sinkhorn_tolerance() {
+    const char *value = getenv(TOLERANCE_ENV_VAR);
+    double tolerance = 0.0;
+
+    if (value != NULL) {
+        tolerance = strtod(value, NULL);
+    }
+    return (tolerance > 0.0) ? tolerance : DEFAULT_SINKHORN_TOLERANCE;
+}
+
+/* Gets the maximal number of sweeps (SUDOKU_SINKHORN_ITERATIONS if it's set to
+ * a positive number). */
+long get_sinkhorn_iterations() {
+    const char *value = getenv(ITERATIONS_ENV_VAR);
+    long num_of_iterations = 0;
+
+    if (value != NULL) {
+        num_of_iterations = strtol(value, NULL, 10);
+    }
+    return (num_of_iterations > 0) ? num_of_iterations : DEFAULT_SINKHORN_ITERATIONS;
+}
+
+/* Starts each empty cell with a uniform distribution over its candidates (and
+ * the filled cells with zeros, so the sweeps can skip the emptiness checks).
+ * Returns false if an empty cell has no candidates. */
+bool init_sinkhorn_scores(const Board *board, double *scores) {
+    int cell, value, num_of_values, dim = board->dim;
+    ValueSet candidates;
+
+    for (cell = 0; cell < dim * dim * dim; cell++) {
+        scores[cell] = 0.0;
+    }
+    for (cell = 0; cell < dim * dim; cell++) {
+        if (!is_cell_empty(board, cell / dim, cell % dim)) {
+            continue;
+        }
+        get_cell_candidates(board, &candidates, cell / dim, cell % dim);
+        num_of_values = count_values(&candidates);
+        if (num_of_values == 0) {
+            return false;
+        }
+        for (value = get_next_value(&candidates, CLEAR); value != CLEAR; value = get_next_value(&candidates, value)) {
+            scores[cell * dim + value - 1] = 1.0 / num_of_values;
+        }
+    }
+    return true;
+}
+
+/* Rescales the unit's cells so the probabilities of each of its missing values
+ * sum to 1, and updates the deviation with the scale factor furthest from 1.
+ * Returns false if a missing value has no probability left. */
+bool balance_sinkhorn_unit(double *scores, int dim, const int *cells, const ValueSet *used, double *factors,
+                           double *deviation) {
+    int i, v;
+    double *row;
+
+    for (v = 0; v < dim; v++) {
+        factors[v] = 0.0;
+    }
+    for (i = 0; i < dim; i++) {
+        row = scores + cells[i] * dim;
+        for (v = 0; v < dim; v++) {
+            factors[v] += row[v];
+        }
+    }
+
+    for (v = 0; v < dim; v++) {
+        if (contains_value(used, v + 1)) {
+            factors[v] = 1.0;
+            continue;
+        }
+        if (factors[v] <= 0.0) {
+            return false;
+        }
+        factors[v] = 1.0 / factors[v];
+        if (ABS(factors[v] - 1.0) > *deviation) {
+            *deviation = ABS(factors[v] - 1.0);
+        }
+    }
+
+    for (i = 0; i < dim; i++) {
+        row = scores + cells[i] * dim;
+        for (v = 0; v < dim; v++) {
+            row[v] *= factors[v];
+        }
+    }
+    return true;
+}
+
+/* Rescales each empty cell so its probabilities sum to 1, and updates the
+ * deviation with the scale factor furthest from 1. Returns false if a cell
+ * has no probability left. */
+bool balance_sinkhorn_cells(const Board *board, double *scores, double *deviation) {
+    int cell, v, dim = board->dim;
+    double sum, factor, *row;
+
+    for (cell = 0; cell < dim * dim; cell++) {
+        if (!is_cell_empty(board, cell / dim, cell % dim)) {
+            continue;
+        }
+        row = scores + cell * dim;
+        sum = 0.0;
+        for (v = 0; v < dim; v++) {
+            sum += row[v];
+        }
+        if (sum <= 0.0) {
+            return false;
+        }
+        factor = 1.0 / sum;
+        for (v = 0; v < dim; v++) {
+            row[v] *= factor;
+        }
+        if (ABS(factor - 1.0) > *deviation) {
+            *deviation = ABS(factor - 1.0);
+        }
+    }
+    return true;
+}
+
+bool get_sinkhorn_marginals(const Board *board, double *scores) {
+    int type, unit, dim = board->dim;
+    long iteration, num_of_iterations = get_sinkhorn_iterations();
+    double deviation = 0.0, tolerance = get_sinkhorn_tolerance(), *factors;
+    bool balanced = true;
+
+    if (!init_sinkhorn_scores(board, scores)) {
+        return false;
+    }
+    if (board->empty_count == 0) {
+        return !is_board_erroneous(board);
+    }
+
+    factors = malloc(dim * sizeof(double));
+    validate_memory_allocation("get_sinkhorn_marginals", factors);
+
+    for (iteration = 0; balanced && iteration < num_of_iterations; iteration++) {
+        deviation = 0.0;
+        for (type = 0; balanced && type < NUM_OF_UNIT_TYPES; type++) {
+            for (unit = 0; balanced && unit < dim; unit++) {
+                balanced = balance_sinkhorn_unit(scores, dim, get_unit_cells(board, (UnitType) type, unit),
+                                                 get_unit_values(board, (UnitType) type, unit), factors, &deviation);
+            }
+        }
+        balanced = balanced && balance_sinkhorn_cells(board, scores, &deviation);
+        if (deviation < tolerance) {
+            break;
+        }
+    }
+
+    free(factors);
+    return balanced;
+}
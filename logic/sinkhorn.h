@@ -0,0 +1,38 @@
+#include <stdbool.h>
+#include "../components/Board.h"
+
+#ifndef FINAL_PROJECT_SINKHORN_H
+#define FINAL_PROJECT_SINKHORN_H
+
+/** sinkhorn:
+ *
+ *  Estimates the probability of each value of each empty cell by Sinkhorn
+ *  balancing (iterative proportional fitting) over the constraints of the LP
+ *  model (see simplex.h): starting from a uniform distribution over each
+ *  cell's candidates, each sweep rescales every value of every row, column
+ *  and block so its probabilities sum to 1, and then every cell so its values
+ *  sum to 1. The result is the most uniform (maximum entropy) point that
+ *  balances the constraints, which makes a much cheaper (if approximate)
+ *  guess than solving the LP.
+ *  The sweeps stop once no scale factor is further than the tolerance from 1,
+ *  or after the maximal number of sweeps. These are read from the
+ *  SUDOKU_SINKHORN_TOLERANCE and SUDOKU_SINKHORN_ITERATIONS environment
+ *  variables, with the defaults below.
+ */
+
+#define DEFAULT_SINKHORN_TOLERANCE (1e-4)
+#define DEFAULT_SINKHORN_ITERATIONS (200)
+
+/**
+ * Fills the scores of the board's empty cells with their estimated value
+ * probabilities. The get_marginals operation of the sinkhorn backend.
+ * @param board: the board to get the scores for.
+ * @param scores: an array of dim^3 scores to fill, indexed as in backend.h
+ * (0 for the values that aren't legal).
+ * @return: true if the scores were filled, and false if the constraints can't
+ * be balanced (a cell or a missing value of a unit has no candidates left, so
+ * the board has no solution).
+ */
+bool get_sinkhorn_marginals(const Board *board, double *scores);
+
+#endif
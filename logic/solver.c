@@ -4,21 +4,58 @@
 #include "solver.h"
 #include "../MemoryError.h"
 #include "random.h"
-#include "../components/StatesList.h"
 
-#define VAR_NAME_LEN (100)
+#define NAME_LEN (100)
 #define RANGE_CONST (10)
+#define VAR_NAME_FORMAT "x[(%d,%d),%d]"
 #define CELL_NAME_FORMAT "cell[%d,%d]"
 #define ROW_NAME_FORMAT "row_val[%d,%d]"
 #define COLUMN_NAME_FORMAT "column_val[%d,%d]"
-
-
-/* Types of constraints of the same structure */
-typedef enum {
-    cell,
-    row,
-    column
-} ConstraintType;
+#define BLOCK_NAME_FORMAT "block_val[(%d,%d),%d]"
+#define DEBUG_ENV_VAR "SUDOKU_GUROBI_DEBUG"
+#define LOG_FILE_NAME "sudoku.log"
+#define MODEL_FILE_NAME "sudoku.lp"
+#define NUM_OF_VARIABLE_TYPES (2)
+#define NUM_OF_UNIT_TYPES (3)
+#define CONSTRAINTS_PER_VAR (4) /* its cell's, and its value's in its row, column and block */
+
+
+/* The Gurobi environment, loaded on first use and kept until the process exits */
+static GRBenv *gurobi_env = NULL;
+
+/* A model that's kept between calls, with the board it describes */
+typedef struct {
+    GRBmodel *model;
+    int *cell_vars;             /* where the variables of each cell start (and, at [dim * dim], where they end) */
+    int *var_values;            /* the value of each variable (the variables of each cell are in increasing value) */
+    int vars_counter;           /* the number of variables */
+    int *built_values;          /* the value of each cell when the model was built */
+    int *values;                /* the value of each cell the bounds fix (CLEAR if free) */
+    bool synced;                /* false if the model has to be rebuilt */
+} GurobiModel;
+
+/* A model assembled in memory, in the layout of GRBaddvars and GRBaddconstrs
+ * (the variables of each constraint are a row of a CSR matrix, where all the
+ * coefficients, and right hand sides, are 1) */
+typedef struct {
+    int num_of_vars;
+    double *objective;
+    double *upper_bounds;
+    char *var_types;
+    int num_of_constraints;
+    int num_of_nonzeros;
+    int *constraint_begins;     /* where each constraint's variables start in constraint_vars */
+    int *constraint_vars;
+    double *ones;               /* the coefficients and right hand sides */
+    char *senses;
+    char **var_names;           /* the names, or NULL if they're not needed */
+    char **constraint_names;
+    char *names;                /* the characters of all the names */
+} ModelBuffers;
+
+/* The models built so far, reused by the boards of the same shape, by
+ * [rows_in_block][columns_in_block][var_type] */
+static GurobiModel *gurobi_models[MAX_DIM + 1][MAX_DIM + 1][NUM_OF_VARIABLE_TYPES];
 
 
 /* Gurobi ILP/LP Model Solving */
@@ -29,506 +66,703 @@ bool handle_gurobi_error(GRBenv *env, char *func_name, int error_code) {
     return false;
 }
 
-/* Frees resources used in the gurobi solver */
-void free_gurobi_resources(GRBenv *env, GRBmodel *model, int *vars_indices) {
-    free(vars_indices);
-    GRBfreemodel(model);
-    GRBfreeenv(env);
+/* Gets the objective function variable coefficient based on the given
+ * VariableType. in case of a continuous variable (LP) randomly chooses a
+ * coefficient in a range determined by the board dimension. */
+double get_objective_coefficient(VariableType var_type, int dim) {
+    switch (var_type) {
+        case integer:
+            return 1.0;
+        case continuous:
+            return get_rand_index(dim * dim * RANGE_CONST);
+        default:
+            return 1.0;
+    }
 }
 
-/* Sets the constraint indices and coefficients */
-void set_constraint(int *constraint_indices, double *constraint_coefs, const int *vars_indices, int *vars_counter,
-        int index) {
-    constraint_indices[*vars_counter] = vars_indices[index];
-    constraint_coefs[*vars_counter] = 1.0;
-    (*vars_counter)++;
+/* Gets the Gurobi variable type based on the given VariableType. */
+char get_gurobi_var_type(VariableType var_type) {
+    switch (var_type) {
+        case integer:
+            return GRB_BINARY;
+        case continuous:
+            return GRB_CONTINUOUS;
+        default:
+            return GRB_BINARY;
+    }
 }
 
-/* Adds a constraint to the model */
-bool add_constraints(GRBenv *env, GRBmodel *model, int dim, char *name, int *vars_indices,
-        int *constraint_indices, double *constraint_coefs, int vars_counter) {
-    int error, index;
-    for (index = vars_counter; index < dim; index++) {
-        constraint_indices[index] = 0;
-        constraint_coefs[index] = 0.0;
+/* Creates the buffers of a model of num_of_vars variables and at most
+ * max_constraints constraints (with the names if they're needed). */
+ModelBuffers* create_model_buffers(int num_of_vars, int max_constraints, bool with_names) {
+    int i, num_of_nonzeros = CONSTRAINTS_PER_VAR * num_of_vars;
+    ModelBuffers *buffers = malloc(sizeof(ModelBuffers));
+    validate_memory_allocation("create_model_buffers", buffers);
+
+    buffers->num_of_vars = 0;
+    buffers->objective = malloc(num_of_vars * sizeof(double));
+    validate_memory_allocation("create_model_buffers", buffers->objective);
+    buffers->upper_bounds = malloc(num_of_vars * sizeof(double));
+    validate_memory_allocation("create_model_buffers", buffers->upper_bounds);
+    buffers->var_types = malloc(num_of_vars * sizeof(char));
+    validate_memory_allocation("create_model_buffers", buffers->var_types);
+
+    buffers->num_of_constraints = 0;
+    buffers->num_of_nonzeros = 0;
+    buffers->constraint_begins = malloc(max_constraints * sizeof(int));
+    validate_memory_allocation("create_model_buffers", buffers->constraint_begins);
+    buffers->constraint_vars = malloc(num_of_nonzeros * sizeof(int));
+    validate_memory_allocation("create_model_buffers", buffers->constraint_vars);
+    buffers->ones = malloc(num_of_nonzeros * sizeof(double));
+    validate_memory_allocation("create_model_buffers", buffers->ones);
+    buffers->senses = malloc(max_constraints * sizeof(char));
+    validate_memory_allocation("create_model_buffers", buffers->senses);
+    /* every constraint has a nonzero, so there are enough ones for the right hand sides */
+    for (i = 0; i < num_of_nonzeros; i++) {
+        buffers->ones[i] = 1.0;
     }
-
-    error = GRBaddconstr(model, vars_counter, constraint_indices, constraint_coefs, GRB_EQUAL, 1.0, name);
-    if (error) {
-        free_gurobi_resources(env, model, vars_indices);
-        return handle_gurobi_error(env, "GRBaddconstr", error);
+    for (i = 0; i < max_constraints; i++) {
+        buffers->senses[i] = GRB_EQUAL;
     }
-    return true;
-}
 
-/* Calculates the variable index based on the type of the constraint */
-int calc_index_for_constraint(ConstraintType type, int primary, int secondary, int internal, int dim) {
-    switch (type) {
-        case cell:
-            return primary*dim*dim + secondary*dim + internal;
-        case row:
-            return secondary*dim*dim + internal*dim + primary;
-        case column:
-            return internal*dim*dim + secondary*dim + primary;
-        default:
-            return 0;
+    buffers->var_names = NULL;
+    buffers->constraint_names = NULL;
+    buffers->names = NULL;
+    if (with_names) {
+        buffers->names = malloc((num_of_vars + max_constraints) * NAME_LEN * sizeof(char));
+        validate_memory_allocation("create_model_buffers", buffers->names);
+        buffers->var_names = malloc(num_of_vars * sizeof(char*));
+        validate_memory_allocation("create_model_buffers", buffers->var_names);
+        buffers->constraint_names = malloc(max_constraints * sizeof(char*));
+        validate_memory_allocation("create_model_buffers", buffers->constraint_names);
+        for (i = 0; i < num_of_vars; i++) {
+            buffers->var_names[i] = buffers->names + i * NAME_LEN;
+        }
+        for (i = 0; i < max_constraints; i++) {
+            buffers->constraint_names[i] = buffers->names + (num_of_vars + i) * NAME_LEN;
+        }
     }
+    return buffers;
 }
 
-/* Formats the name of constraint */
-void format_constraint_name(ConstraintType type, int primary, int secondary, char *name) {
-    switch (type) {
-        case cell:
-            sprintf(name, CELL_NAME_FORMAT, primary, secondary);
-            return;
-        case row:
-            sprintf(name, ROW_NAME_FORMAT, secondary, primary + 1);
-            return;
-        case column:
-            sprintf(name, COLUMN_NAME_FORMAT, secondary, primary + 1);
-            return;
-    }
+/* Destroys the given buffers (frees all related memory). */
+void destroy_model_buffers(ModelBuffers *buffers) {
+    free(buffers->objective);
+    free(buffers->upper_bounds);
+    free(buffers->var_types);
+    free(buffers->constraint_begins);
+    free(buffers->constraint_vars);
+    free(buffers->ones);
+    free(buffers->senses);
+    free(buffers->var_names);
+    free(buffers->constraint_names);
+    free(buffers->names);
+    free(buffers);
 }
 
-/* Adds constraints by type (cell, row, column):
- *  # 'cell' - make sure each cell has exactly one value */
-/*  # 'row' - make sure each value appears exactly once in each row */
-/*  # 'column' - make sure each value appears exactly once in each column */
-bool add_constraints_by_type(GRBenv *env, GRBmodel *model, int dim, int *vars_indices, char *name,
-                             int *constraint_indices, double *constraint_coefs, ConstraintType type) {
-    int primary, secondary, internal, vars_counter;
-    for (primary = 0; primary < dim; primary++) {
-        for (secondary = 0; secondary < dim; secondary++) {
-            vars_counter = 0;
-
-            format_constraint_name(type, primary, secondary, name);
-            for (internal = 0; internal < dim; internal++) {
-                if (vars_indices[calc_index_for_constraint(type, primary, secondary, internal, dim)] == ERROR_VALUE){
-                    continue;
-                }
-                set_constraint(constraint_indices, constraint_coefs, vars_indices, &vars_counter,
-                               calc_index_for_constraint(type, primary, secondary, internal, dim));
-            }
+/* Gets the variable of the cell and value, or ERROR_VALUE if it has none. */
+int find_model_variable(const GurobiModel *kept, int position, int value) {
+    int index;
 
-            if (vars_counter == 0) {
-                continue;
-            }
-
-            if (!add_constraints(env, model, dim, name, vars_indices, constraint_indices,
-                                 constraint_coefs, vars_counter)) {
-                return false;
-            }
+    for (index = kept->cell_vars[position]; index < kept->cell_vars[position + 1]; index++) {
+        if (kept->var_values[index] == value) {
+            return index;
         }
     }
-    return true;
+    return ERROR_VALUE;
 }
 
-/* Adds constraints to make sure each value appears exactly once in each block */
-bool add_block_constraints(GRBenv *env, GRBmodel *model, Board *board, int *vars_indices, char *name,
-                           int *constraint_indices, double *constraint_coefs) {
-    int i, j, v, r_start, c_start, r_end, c_end, index, vars_counter, dim = board->dim;
-    for (v = 0; v < dim; v++) {
-        for (r_start = 0; r_start < dim; r_start += board->num_of_rows_in_block) {
-            r_end = r_start + board->num_of_rows_in_block;
-
-            for (c_start = 0; c_start < dim; c_start += board->num_of_columns_in_block) {
-                c_end = c_start + board->num_of_columns_in_block;
-
-                vars_counter = 0;
-                sprintf(name, "block_val[(%d,%d),%d]", r_start, c_start, v+1);
-
-                for (i = r_start; i < r_end; i++) {
-                    for (j = c_start; j < c_end; j++) {
-                        index = i * dim * dim + j * dim + v;
-                        if (vars_indices[index] == ERROR_VALUE) {
-                            continue;
-                        }
-                        set_constraint(constraint_indices, constraint_coefs, vars_indices, &vars_counter, index);
-                    }
-                }
+/* Numbers a variable for each empty cell and legal value, cell by cell (the
+ * filled cells have none). Returns the number of variables, or ERROR_VALUE
+ * if an empty cell has no legal values. */
+int index_model_variables(GurobiModel *kept, const Board *board) {
+    int position, v, num_of_vars = 0, dim = board->dim;
+    ValueSet *candidates = malloc(dim * dim * sizeof(ValueSet));
+    validate_memory_allocation("index_model_variables", candidates);
+
+    for (position = 0; position < dim * dim; position++) {
+        kept->cell_vars[position] = num_of_vars;
+        /* Only add variables for empty cells. */
+        if (!is_cell_empty(board, position / dim, position % dim)) {
+            continue;
+        }
+        get_cell_candidates(board, &candidates[position], position / dim, position % dim);
+        if (count_values(&candidates[position]) == 0) {
+            free(candidates);
+            return ERROR_VALUE;
+        }
+        num_of_vars += count_values(&candidates[position]);
+    }
+    kept->cell_vars[dim * dim] = num_of_vars;
 
-                if (vars_counter == 0) {
-                    continue;
-                }
+    free(kept->var_values);
+    kept->var_values = malloc((num_of_vars > 0 ? num_of_vars : 1) * sizeof(int));
+    validate_memory_allocation("index_model_variables", kept->var_values);
+    for (position = 0; position < dim * dim; position++) {
+        if (kept->cell_vars[position] == kept->cell_vars[position + 1]) {
+            continue;
+        }
+        num_of_vars = kept->cell_vars[position];
+        v = get_next_value(&candidates[position], CLEAR);
+        while (v != CLEAR) {
+            kept->var_values[num_of_vars++] = v;
+            v = get_next_value(&candidates[position], v);
+        }
+    }
+    free(candidates);
+    return kept->cell_vars[dim * dim];
+}
 
-                if (!add_constraints(env, model, dim, name, vars_indices, constraint_indices,
-                                     constraint_coefs, vars_counter)) {
-                    return false;
-                };
+/* Fills the variables of the buffers, in the order of the model's index. */
+void assemble_model_variables(ModelBuffers *buffers, VariableType var_type, const Board *board,
+                              const GurobiModel *kept) {
+    int position, index, dim = board->dim;
+    char gurobi_var_type = get_gurobi_var_type(var_type);
+
+    for (position = 0; position < dim * dim; position++) {
+        for (index = kept->cell_vars[position]; index < kept->cell_vars[position + 1]; index++) {
+            buffers->objective[index] = get_objective_coefficient(var_type, dim);
+            buffers->upper_bounds[index] = 1.0;
+            buffers->var_types[index] = gurobi_var_type;
+            if (buffers->var_names != NULL) {
+                sprintf(buffers->var_names[index], VAR_NAME_FORMAT, position / dim, position % dim,
+                        kept->var_values[index]);
             }
         }
     }
-    return true;
+    buffers->num_of_vars = kept->vars_counter;
 }
 
-/* Gets the objective function variable coefficient based on the given
- * VariableType. in case of a continuous variable (LP) randomly chooses a
- * coefficient in a range determined by the board dimension. */
-double get_objective_coefficient(VariableType var_type, int dim) {
-    switch (var_type) {
-        case integer:
-            return 1.0;
-        case continuous:
-            return get_rand_index(dim * dim * RANGE_CONST);
-        default:
-            return 1.0;
+/* Formats the name of the constraint of the value in the unit (whose first
+ * cell is given). */
+void format_constraint_name(char *name, UnitType type, int unit, int first_cell, int v, int dim) {
+    switch (type) {
+        case row_unit:
+            sprintf(name, ROW_NAME_FORMAT, unit, v + 1);
+            return;
+        case column_unit:
+            sprintf(name, COLUMN_NAME_FORMAT, unit, v + 1);
+            return;
+        case block_unit:
+            sprintf(name, BLOCK_NAME_FORMAT, first_cell / dim, first_cell % dim, v + 1);
+            return;
     }
 }
 
-/* Gets the Gurobi variable type based on the given VariableType. */
-char get_gurobi_var_type(VariableType var_type) {
-    switch (var_type) {
-        case integer:
-            return GRB_BINARY;
-        case continuous:
-            return GRB_CONTINUOUS;
+/* Gets the key of the constraint of the value (from 0) in the unit of the
+ * given type that has the cell: (type * dim + unit) * dim + v. */
+int get_value_constraint_key(const Board *board, UnitType type, int position, int v) {
+    int unit, dim = board->dim;
+
+    switch (type) {
+        case row_unit:
+            unit = position / dim;
+            break;
+        case column_unit:
+            unit = position % dim;
+            break;
         default:
-            return GRB_BINARY;
+            unit = get_block_index(board, position / dim, position % dim);
+            break;
     }
+    return (type * dim + unit) * dim + v;
 }
 
-/* Adds a variable for each empty cell and legal value */
-bool add_variables(GRBenv *env, GRBmodel *model, VariableType var_type, Board *board,
-        int dim, char *name, int *vars_indices, int *vars_counter) {
-    int i, j, v, error;
-    double obj;
-    char gurobi_var_type;
-    bool has_possible_value, *marks;
-
-    marks = malloc(dim * sizeof(bool));
-    validate_memory_allocation("gurobi_solver: marks", marks);
-
-    for (i = 0; i < dim; i++) {
-        for (j = 0; j < dim; j++) {
-            /* Only add variables for empty cells. */
-            if (!is_cell_empty(board, i, j)) {
-                for (v = 0; v < dim; v++) {
-                    vars_indices[i * dim * dim + j * dim + v] = ERROR_VALUE;
-                }
-                continue;
-            }
+/* Fills the constraints of the buffers:
+ *  # 'cell' - make sure each cell has exactly one value
+ *  # 'row' - make sure each value appears exactly once in each row
+ *  # 'column' - make sure each value appears exactly once in each column
+ *  # 'block' - make sure each value appears exactly once in each block
+ * The variables of the cell constraints are the cells' ranges of the index.
+ * Those of the unit constraints (of the values that are missing from each
+ * unit) are listed by a counting sort of the variables by constraint key,
+ * so it takes time in the number of variables, rather than in dim^3. */
+void assemble_model_constraints(ModelBuffers *buffers, const Board *board, const GurobiModel *kept) {
+    int position, index, type, unit, key, dim = board->dim, num_of_keys = NUM_OF_UNIT_TYPES * dim * dim;
+    int *key_begins = calloc(num_of_keys + 1, sizeof(int));
+    validate_memory_allocation("assemble_model_constraints", key_begins);
+
+    for (position = 0; position < dim * dim; position++) {
+        if (kept->cell_vars[position] == kept->cell_vars[position + 1]) {
+            continue;
+        }
+        if (buffers->constraint_names != NULL) {
+            sprintf(buffers->constraint_names[buffers->num_of_constraints], CELL_NAME_FORMAT,
+                    position / dim, position % dim);
+        }
+        buffers->constraint_begins[buffers->num_of_constraints++] = kept->cell_vars[position];
+    }
+    for (index = 0; index < kept->vars_counter; index++) {
+        buffers->constraint_vars[index] = index;
+    }
 
-            has_possible_value = false;
-            mark_neighboring_values(board, marks, i, j);
-            for (v = 0; v < dim; v++) {
-                if (marks[v]) { /* found conflicting neighbor, so this is not a possible value */
-                    vars_indices[i * dim * dim + j * dim + v] = ERROR_VALUE;
-                }
-                else {
-                    has_possible_value = true;
-                    sprintf(name, "x[(%d,%d),%d]", i, j, v+1);
-                    obj = get_objective_coefficient(var_type, dim);
-                    gurobi_var_type = get_gurobi_var_type(var_type);
-                    error = GRBaddvar(model, 0, NULL, NULL, obj, 0.0, 1.0, gurobi_var_type, name);
-                    if (error) {
-                        free(marks);
-                        free_gurobi_resources(env, model, vars_indices);
-                        return handle_gurobi_error(env, "GRBaddvar", error);
-                    }
-                    vars_indices[i * dim * dim + j * dim + v] = (*vars_counter);
-                    (*vars_counter)++;
-                }
+    /* count the variables of each unit constraint, and find where they start */
+    for (position = 0; position < dim * dim; position++) {
+        for (index = kept->cell_vars[position]; index < kept->cell_vars[position + 1]; index++) {
+            for (type = row_unit; type <= block_unit; type++) {
+                key = get_value_constraint_key(board, (UnitType) type, position, kept->var_values[index] - 1);
+                key_begins[key + 1]++;
             }
-            if (!has_possible_value) {
-                free(marks);
-                free_gurobi_resources(env, model, vars_indices);
-                return false;
+        }
+    }
+    for (key = 0; key < num_of_keys; key++) {
+        key_begins[key + 1] += key_begins[key];
+    }
+    for (key = 0; key < num_of_keys; key++) {
+        if (key_begins[key + 1] == key_begins[key]) {
+            continue;
+        }
+        if (buffers->constraint_names != NULL) {
+            type = key / (dim * dim);
+            unit = (key / dim) % dim;
+            format_constraint_name(buffers->constraint_names[buffers->num_of_constraints], (UnitType) type, unit,
+                                   get_unit_cells(board, (UnitType) type, unit)[0], key % dim, dim);
+        }
+        buffers->constraint_begins[buffers->num_of_constraints++] = kept->vars_counter + key_begins[key];
+    }
+
+    /* place the variables (in increasing order within each constraint) */
+    for (position = 0; position < dim * dim; position++) {
+        for (index = kept->cell_vars[position]; index < kept->cell_vars[position + 1]; index++) {
+            for (type = row_unit; type <= block_unit; type++) {
+                key = get_value_constraint_key(board, (UnitType) type, position, kept->var_values[index] - 1);
+                buffers->constraint_vars[kept->vars_counter + key_begins[key]++] = index;
             }
         }
     }
-    free(marks);
-    return true;
+    buffers->num_of_nonzeros = CONSTRAINTS_PER_VAR * kept->vars_counter;
+    free(key_begins);
 }
 
-/* Asserts some variables were added (otherwise no need for the solver), and
- * updates the model. */
-bool assert_variables_added(GRBenv *env, GRBmodel *model, Board *board,
-        int *vars_indices, const int *vars_counter) {
+/* Adds the variables, and then the constraints, of the buffers to the model. */
+bool add_model_buffers(GRBenv *env, GRBmodel *model, ModelBuffers *buffers) {
     int error;
 
-    /* If no vars were needed, so the board is either solved or is unsolvable */
-    if ((*vars_counter) == 0) {
-        if (!is_board_erroneous(board) && board->empty_count == 0) {
-            free_gurobi_resources(env, model, vars_indices);
-            return true;
-        } else {
-            free_gurobi_resources(env, model, vars_indices);
-            return false;
-        }
+    error = GRBaddvars(model, buffers->num_of_vars, 0, NULL, NULL, NULL, buffers->objective, NULL,
+                       buffers->upper_bounds, buffers->var_types, buffers->var_names);
+    if (error) {
+        return handle_gurobi_error(env, "GRBaddvars", error);
+    }
+    error = GRBupdatemodel(model);
+    if (error) {
+        return handle_gurobi_error(env, "GRBupdatemodel", error);
     }
 
+    error = GRBaddconstrs(model, buffers->num_of_constraints, buffers->num_of_nonzeros, buffers->constraint_begins,
+                          buffers->constraint_vars, buffers->ones, buffers->senses, buffers->ones,
+                          buffers->constraint_names);
+    if (error) {
+        return handle_gurobi_error(env, "GRBaddconstrs", error);
+    }
     error = GRBupdatemodel(model);
     if (error) {
-        free_gurobi_resources(env, model, vars_indices);
         return handle_gurobi_error(env, "GRBupdatemodel", error);
     }
     return true;
 }
 
-/* Sets up the gurobi environment and creates an empty model. */
-bool set_environment(GRBenv **env, GRBmodel **model) {
+/* Checks if the solver should leave files to debug with (SUDOKU_GUROBI_DEBUG
+ * is set): a log (LOG_FILE_NAME), and the last model built (MODEL_FILE_NAME). */
+bool is_gurobi_debug() {
+    return getenv(DEBUG_ENV_VAR) != NULL;
+}
+
+/* Gets the gurobi environment, loading it on first use. Returns NULL if it
+ * can't be loaded. */
+GRBenv* get_gurobi_env() {
     int error;
 
-    error = GRBloadenv(env, "sudoku.log");
+    if (gurobi_env != NULL) {
+        return gurobi_env;
+    }
+
+    error = GRBloadenv(&gurobi_env, is_gurobi_debug() ? LOG_FILE_NAME : NULL);
+    if (!error) {
+        error = GRBsetintparam(gurobi_env, GRB_INT_PAR_LOGTOCONSOLE, 0);
+    }
     if (error) {
-        free_gurobi_resources(*env, *model, NULL);
-        return handle_gurobi_error(*env, "GRBloadenv", error);
+        handle_gurobi_error(gurobi_env, "GRBloadenv", error);
+        GRBfreeenv(gurobi_env);
+        gurobi_env = NULL;
     }
+    return gurobi_env;
+}
 
-    error = GRBsetintparam(*env, GRB_INT_PAR_LOGTOCONSOLE, 0);
+/* Removes all the variables and constraints of the model, so it can be
+ * reused. Returns false on error. */
+bool clear_gurobi_model(GRBmodel *model) {
+    int error, i, num_of_vars, num_of_constraints;
+    int *indices;
+
+    error = GRBupdatemodel(model); /* so changes that were left pending are counted */
+    if (!error) {
+        error = GRBgetintattr(model, GRB_INT_ATTR_NUMVARS, &num_of_vars);
+    }
+    if (!error) {
+        error = GRBgetintattr(model, GRB_INT_ATTR_NUMCONSTRS, &num_of_constraints);
+    }
     if (error) {
-        free_gurobi_resources(*env, *model, NULL);
-        return handle_gurobi_error(*env, "GRBsetintparam", error);
+        return false;
+    }
+    if (num_of_vars == 0 && num_of_constraints == 0) {
+        return true;
     }
 
-    error = GRBnewmodel(*env, model, "sudoku_model", 0, NULL, NULL, NULL, NULL, NULL);
+    indices = malloc((num_of_vars > num_of_constraints ? num_of_vars : num_of_constraints) * sizeof(int));
+    validate_memory_allocation("clear_gurobi_model", indices);
+    for (i = 0; i < num_of_vars || i < num_of_constraints; i++) {
+        indices[i] = i;
+    }
+    error = GRBdelconstrs(model, num_of_constraints, indices);
+    if (!error) {
+        error = GRBdelvars(model, num_of_vars, indices);
+    }
+    if (!error) {
+        error = GRBupdatemodel(model);
+    }
+    free(indices);
+    return !error;
+}
+
+/* Creates a model for boards of the given dimension, that has to be built
+ * before it's used. Returns NULL on error. */
+GurobiModel* create_gurobi_model(GRBenv *env, int dim) {
+    int error;
+    GurobiModel *kept = malloc(sizeof(GurobiModel));
+    validate_memory_allocation("create_gurobi_model", kept);
+
+    error = GRBnewmodel(env, &kept->model, "sudoku_model", 0, NULL, NULL, NULL, NULL, NULL);
     if (error) {
-        free_gurobi_resources(*env, *model, NULL);
-        return handle_gurobi_error(*env, "GRBnewmodel", error);
+        handle_gurobi_error(env, "GRBnewmodel", error);
+        GRBfreemodel(kept->model);
+        free(kept);
+        return NULL;
     }
 
-    return true;
+    kept->cell_vars = malloc((dim * dim + 1) * sizeof(int));
+    validate_memory_allocation("create_gurobi_model", kept->cell_vars);
+    kept->var_values = NULL;
+    kept->built_values = malloc(dim * dim * sizeof(int));
+    validate_memory_allocation("create_gurobi_model", kept->built_values);
+    kept->values = malloc(dim * dim * sizeof(int));
+    validate_memory_allocation("create_gurobi_model", kept->values);
+    kept->vars_counter = 0;
+    kept->synced = false;
+    return kept;
 }
 
-/* Extracts the optimal solution probabilities for a single cell, and updates
- * the given guesses array accordingly. */
-bool get_cell_guess_probabilities(GRBenv *env, GRBmodel *model, double *guesses,
-        int row, int column, int dim, int *vars_indices) {
-    int error, v, index;
+/* Destroys the given model (frees all related memory). */
+void destroy_gurobi_model(GurobiModel *kept) {
+    GRBfreemodel(kept->model);
+    free(kept->cell_vars);
+    free(kept->var_values);
+    free(kept->built_values);
+    free(kept->values);
+    free(kept);
+}
 
-    for (v = 0; v < dim; v++) {
-        index = vars_indices[row * dim * dim + column * dim + v];
-        if (index == ERROR_VALUE) {
-            guesses[v] = 0.0;
-            continue;
-        }
-        error = GRBgetdblattrelement(model, GRB_DBL_ATTR_X, index, &(guesses[v]));
-        if (error) {
-            free_gurobi_resources(env, model, vars_indices);
-            return handle_gurobi_error(env, "GRBgetdblattrelement", error);
+/* Checks if the model can describe the board by changing the bounds of its
+ * variables: the cells that were filled when it was built still are (with
+ * the same values), and the rest are empty or filled with values that have
+ * variables. */
+bool is_gurobi_model_reusable(const GurobiModel *kept, const Board *board) {
+    int position, value, dim = board->dim;
+
+    if (!kept->synced) {
+        return false;
+    }
+    for (position = 0; position < dim * dim; position++) {
+        value = get_cell_value(board, position / dim, position % dim);
+        if (kept->built_values[position] != CLEAR) {
+            if (value != kept->built_values[position]) {
+                return false;
+            }
+        } else if (value != CLEAR && find_model_variable(kept, position, value) == ERROR_VALUE) {
+            return false;
         }
     }
     return true;
 }
 
-/* Extracts the optimal solution probabilities for a single cell, and updates
- * the data's guesses array accordingly. */
-bool fill_cell_guess_solution(GRBenv *env, GRBmodel *model, SolutionData *data,
-        int dim, int *vars_indices) {
-    double *guesses = malloc(dim * sizeof(double));
-    validate_memory_allocation("fill_cell_guess_solution", guesses);
+/* Gets the model of the board's shape and variable type. It's the model of
+ * the last board of that shape if it can describe the board (see
+ * is_gurobi_model_reusable), and otherwise an empty model to build. Returns
+ * NULL on error. */
+GurobiModel* get_gurobi_model(GRBenv *env, const Board *board, VariableType var_type) {
+    GurobiModel **kept = &gurobi_models[board->num_of_rows_in_block][board->num_of_columns_in_block][var_type];
+
+    if (*kept != NULL && !is_gurobi_model_reusable(*kept, board)) {
+        (*kept)->synced = false;
+        if (!clear_gurobi_model((*kept)->model)) {
+            destroy_gurobi_model(*kept); /* start over with a new model */
+            *kept = NULL;
+        }
+    }
+    if (*kept == NULL) {
+        *kept = create_gurobi_model(env, board->dim);
+    }
+    return *kept;
+}
 
-    if (!get_cell_guess_probabilities(env, model, guesses, data->row, data->column, dim, vars_indices)) {
-        free(guesses);
+/* Builds the model of the board into an empty model: a variable for each
+ * empty cell and legal value, and the constraints over them. Returns false
+ * on error, or if an empty cell has no legal values. */
+bool build_gurobi_model(GRBenv *env, GurobiModel *kept, const Board *board, VariableType var_type) {
+    int error, index, dim = board->dim;
+    bool debug = is_gurobi_debug(), success = true;
+    ModelBuffers *buffers;
+
+    /* Number the variables */
+    kept->vars_counter = index_model_variables(kept, board);
+    if (kept->vars_counter == ERROR_VALUE) {
+        kept->vars_counter = 0;
         return false;
     }
 
-    data->guesses = guesses;
+    /* Assemble the model and add it in bulk (if no vars were needed, the
+     * board has no empty cells) */
+    if (kept->vars_counter > 0) {
+        buffers = create_model_buffers(kept->vars_counter, board->empty_count + NUM_OF_UNIT_TYPES * dim * dim, debug);
+        assemble_model_variables(buffers, var_type, board, kept);
+        assemble_model_constraints(buffers, board, kept);
+        success = add_model_buffers(env, kept->model, buffers);
+        destroy_model_buffers(buffers);
+        if (!success) {
+            return false;
+        }
+    }
+
+    /* Write model to MODEL_FILE_NAME, when debugging */
+    if (debug) {
+        error = GRBwrite(kept->model, MODEL_FILE_NAME);
+        if (error) {
+            return handle_gurobi_error(env, "GRBwrite", error);
+        }
+    }
+
+    for (index = 0; index < dim * dim; index++) {
+        kept->built_values[index] = get_cell_value(board, index / dim, index % dim);
+        kept->values[index] = kept->built_values[index];
+    }
     return true;
 }
 
-/* Clears illegal values created along the way from the probabilities so they won't
- * be considered */
-void clear_illegal_probabilities(Board *board, double *guesses, bool *marks, int i, int j) {
-    int v;
-    mark_neighboring_values(board, marks, i, j);
+/* Updates the model to describe the board, by changing the bounds of the
+ * variables of the cells that changed since it was last used: the variables
+ * of an empty cell are free (0 to 1), and those of a filled cell are fixed to
+ * its value. Returns false on error. */
+bool update_gurobi_bounds(GRBenv *env, GurobiModel *kept, const Board *board) {
+    int position, index, value, error = 0, num_of_changes = 0, dim = board->dim;
+    int *changed_indices;
+    double *lower_bounds, *upper_bounds;
 
-    for (v = 0; v < board->dim; v++) {
-        if (marks[v]) {
-            guesses[v] = 0.0;
+    if (kept->vars_counter == 0) {
+        return true;
+    }
+    changed_indices = malloc(kept->vars_counter * sizeof(int));
+    validate_memory_allocation("update_gurobi_bounds", changed_indices);
+    lower_bounds = malloc(kept->vars_counter * sizeof(double));
+    validate_memory_allocation("update_gurobi_bounds", lower_bounds);
+    upper_bounds = malloc(kept->vars_counter * sizeof(double));
+    validate_memory_allocation("update_gurobi_bounds", upper_bounds);
+
+    for (position = 0; position < dim * dim; position++) {
+        value = get_cell_value(board, position / dim, position % dim);
+        if (kept->built_values[position] != CLEAR || value == kept->values[position]) {
+            continue;
+        }
+        for (index = kept->cell_vars[position]; index < kept->cell_vars[position + 1]; index++) {
+            changed_indices[num_of_changes] = index;
+            lower_bounds[num_of_changes] = (value == kept->var_values[index]) ? 1.0 : 0.0;
+            upper_bounds[num_of_changes] = (value == CLEAR || value == kept->var_values[index]) ? 1.0 : 0.0;
+            num_of_changes++;
         }
+        kept->values[position] = value;
     }
-}
 
-/* Extracts the optimal solution, and updates the board accordingly */
-bool fill_board_guess_solution(GRBenv *env, GRBmodel *model, Board *board, States *states,
-        double threshold, int *vars_indices, int vars_counter) {
-    int error, i, j, value, dim = board->dim;
-    double *solution, *guesses;
-    bool *marks;
-
-    solution = malloc(vars_counter * sizeof(double));
-    validate_memory_allocation("fill_board_guess_solution", solution);
-    guesses = malloc(dim * sizeof(double));
-    validate_memory_allocation("fill_cell_guess_solution", guesses);
-    marks = malloc(dim * sizeof(bool));
-    validate_memory_allocation("gurobi_solver: marks", marks);
-
-    error = GRBgetdblattrarray(model, GRB_DBL_ATTR_X, 0, vars_counter, solution);
+    if (num_of_changes > 0) {
+        error = GRBsetdblattrlist(kept->model, GRB_DBL_ATTR_LB, num_of_changes, changed_indices, lower_bounds);
+        if (!error) {
+            error = GRBsetdblattrlist(kept->model, GRB_DBL_ATTR_UB, num_of_changes, changed_indices, upper_bounds);
+        }
+    }
+    free(changed_indices);
+    free(lower_bounds);
+    free(upper_bounds);
     if (error) {
-        free(guesses);
-        free(solution);
-        free(marks);
-        free_gurobi_resources(env, model, vars_indices);
-        return handle_gurobi_error(env, "GRBgetdblattrarray", error);
+        return handle_gurobi_error(env, "GRBsetdblattrlist", error);
     }
+    return true;
+}
 
-    for (i = 0; i < dim; i++) {
-        for (j = 0; j < dim; j++) {
-            if (!is_cell_empty(board, i, j)) {
-                continue;
-            }
+/* Draws new objective coefficients for the variables of the model (see
+ * get_objective_coefficient), as a new model would have. Returns false on
+ * error. */
+bool update_gurobi_objective(GRBenv *env, GurobiModel *kept, VariableType var_type, int dim) {
+    int error, i;
+    double *objective;
 
-            if (!get_cell_guess_probabilities(env, model, guesses, i, j, dim, vars_indices)) {
-                continue;
-            }
+    if (var_type != continuous || kept->vars_counter == 0) {
+        return true; /* the objective of the ILP is constant */
+    }
+    objective = malloc(kept->vars_counter * sizeof(double));
+    validate_memory_allocation("update_gurobi_objective", objective);
+    for (i = 0; i < kept->vars_counter; i++) {
+        objective[i] = get_objective_coefficient(var_type, dim);
+    }
 
-            clear_illegal_probabilities(board, guesses, marks, i, j);
-            value = weighted_random_choice_with_threshold(guesses, dim, threshold);
-            if (value == ERROR_VALUE) {
-                continue;
-            }
-            make_change(board, states, i, j, value+1);
-        }
+    error = GRBsetdblattrarray(kept->model, GRB_DBL_ATTR_OBJ, 0, kept->vars_counter, objective);
+    free(objective);
+    if (error) {
+        return handle_gurobi_error(env, "GRBsetdblattrarray", error);
     }
-    free(guesses);
-    free(solution);
-    free(marks);
     return true;
 }
 
-/* Extracts the optimal solution, and updates the board accordingly */
-bool fill_board_solution(GRBenv *env, GRBmodel *model, Board *board, States *states,
-        int *vars_indices, int vars_counter) {
-    int error, i, j, v, dim = board->dim;
+/* Extracts the optimal solution, and fills the scores of the board's empty
+ * cells and values with it (and 0 for the rest). */
+bool fill_scores(GRBenv *env, GurobiModel *kept, const Board *board, double *scores) {
+    int error, i, position, index, dim = board->dim;
 
-    double *solution = malloc(vars_counter * sizeof(double));
-    validate_memory_allocation("fill_board_solution", solution);
+    double *solution = malloc(kept->vars_counter * sizeof(double));
+    validate_memory_allocation("fill_scores", solution);
 
-    error = GRBgetdblattrarray(model, GRB_DBL_ATTR_X, 0, vars_counter, solution);
+    error = GRBgetdblattrarray(kept->model, GRB_DBL_ATTR_X, 0, kept->vars_counter, solution);
     if (error) {
         free(solution);
-        free_gurobi_resources(env, model, vars_indices);
         return handle_gurobi_error(env, "GRBgetdblattrarray", error);
     }
 
-    for (i = 0; i < dim; i++) {
-        for (j = 0; j < dim; j++) {
-            for (v = 0; v < dim; v++) {
-                if (vars_indices[i * dim * dim + j * dim + v] == ERROR_VALUE) {
-                    continue;
-                }
-
-                if (solution[vars_indices[i * dim * dim + j * dim + v]] == 1.0) {
-                    if (states != NULL) {
-                        make_change(board, states, i, j, v+1);
-                    } else {
-                        set_cell_value(board, i, j, v+1);
-                    }
-                }
-            }
+    for (i = 0; i < dim * dim * dim; i++) {
+        scores[i] = 0.0;
+    }
+    for (position = 0; position < dim * dim; position++) {
+        if (!is_cell_empty(board, position / dim, position % dim)) {
+            continue;
+        }
+        for (index = kept->cell_vars[position]; index < kept->cell_vars[position + 1]; index++) {
+            scores[position * dim + kept->var_values[index] - 1] = solution[index];
         }
     }
     free(solution);
-
-    /* Check if the board is solved */
-    if (!is_board_erroneous(board) && board->empty_count == 0) {
-        return true;
-    } else {
-        return false;
-    }
+    return true;
 }
 
-/* Fills the optimal solution that was found based on the type of variable (determines
- * LP/ILP), and the solution type (whole board or single cell). */
-bool fill_solution(GRBenv *env, GRBmodel *model, Board *board, States *states, VariableType var_type,
-        SolutionType sol_type, SolutionData *data, double threshold, int *vars_indices, int vars_counter) {
-    switch (var_type) {
-        case integer:
-            return fill_board_solution(env, model, board, states, vars_indices, vars_counter);
-        case continuous:
-            switch (sol_type) {
-                case cell_hint:
-                    return fill_cell_guess_solution(env, model, data, board->dim, vars_indices);
-                case solve_board:
-                    return fill_board_guess_solution(env, model, board, states, threshold, vars_indices, vars_counter);
-                default:
-                    return false;
-            }
-        default:
-            return false;
-    }
-}
 
+/* The main board solving function. Solves the board if possible using ILP/LP, and fills the scores
+ * with the solution. Returns true on success, or false on error. */
+bool gurobi_solver(const Board *board, VariableType var_type, double *scores) {
+    GRBenv      *env;
+    GurobiModel *kept;
+    int          error = 0;
+    int          i, dim = board->dim;
+    int          optstatus;
 
-/* The main board solving function. Solves the board if possible using ILP/LP, and returns true on
- * success, or false on error. */
-bool gurobi_solver(Board *board, States *states, VariableType var_type, SolutionType sol_type,
-                   SolutionData *data, double threshold) {
-    GRBenv   *env = NULL;
-    GRBmodel *model = NULL;
-    int       error = 0;
-    char      name[VAR_NAME_LEN];
-    int       dim = board->dim;
-    int       optstatus, vars_counter = 0;
-    bool      success;
-    int      *vars_indices = NULL;
-    int      *constraint_indices = NULL;
-    double   *constraint_coefs = NULL;
-
-    /* Create environment & model */
-    set_environment(&env, &model);
-
-    /* Add variables */
-    vars_indices = malloc(dim * dim * dim * sizeof(int));
-    validate_memory_allocation("gurobi_solver: vars_indices", vars_indices);
-    if (!add_variables(env, model, var_type, board, dim, name, vars_indices, &vars_counter)) {
+    /* Get the environment & the model */
+    env = get_gurobi_env();
+    if (env == NULL) {
         return false;
-    };
-    assert_variables_added(env, model, board, vars_indices, &vars_counter);
-
-    /* Add constraints */
-    constraint_indices = malloc(dim * sizeof(int));
-    validate_memory_allocation("gurobi_solver: constraint_indices", constraint_indices);
-    constraint_coefs = malloc(dim * sizeof(double));
-    validate_memory_allocation("gurobi_solver: constraint_coefs", constraint_coefs);
-
-    if (!add_constraints_by_type(env, model, dim, vars_indices, name, constraint_indices, constraint_coefs, cell)
-     || !add_constraints_by_type(env, model, dim, vars_indices, name, constraint_indices, constraint_coefs, row)
-     || !add_constraints_by_type(env, model, dim, vars_indices, name, constraint_indices, constraint_coefs, column)
-     || !add_block_constraints(env, model, board, vars_indices, name, constraint_indices, constraint_coefs)) {
-        free(constraint_indices);
-        free(constraint_coefs);
+    }
+    kept = get_gurobi_model(env, board, var_type);
+    if (kept == NULL) {
         return false;
     }
-    free(constraint_indices);
-    free(constraint_coefs);
 
-    error = GRBupdatemodel(model);
-    if (error) {
-        free_gurobi_resources(env, model, vars_indices);
-        return handle_gurobi_error(env, "GRBupdatemodel", error);
+    /* Build the model, or update the kept one */
+    if (kept->synced) {
+        kept->synced = update_gurobi_bounds(env, kept, board) && update_gurobi_objective(env, kept, var_type, dim);
+    } else {
+        kept->synced = build_gurobi_model(env, kept, board, var_type);
+    }
+    if (!kept->synced) {
+        return false;
     }
 
-    /* Write model to 'sudoku.lp'*/
-    error = GRBwrite(model, "sudoku.lp");
-    if (error) {
-        free_gurobi_resources(env, model, vars_indices);
-        return handle_gurobi_error(env, "GRBwrite", error);
+    /* If no vars were needed, the board is either solved or is unsolvable */
+    if (kept->vars_counter == 0) {
+        for (i = 0; i < dim * dim * dim; i++) {
+            scores[i] = 0.0;
+        }
+        return !is_board_erroneous(board) && board->empty_count == 0;
     }
 
     /* Solve */
-    error = GRBoptimize(model);
+    error = GRBoptimize(kept->model);
     if (error) {
-        free_gurobi_resources(env, model, vars_indices);
+        kept->synced = false;
         return handle_gurobi_error(env, "GRBoptimize", error);
     }
 
-    error = GRBgetintattr(model, GRB_INT_ATTR_STATUS, &optstatus);
+    error = GRBgetintattr(kept->model, GRB_INT_ATTR_STATUS, &optstatus);
     if (error) {
-        free_gurobi_resources(env, model, vars_indices);
+        kept->synced = false;
         return handle_gurobi_error(env, "GRBgetintattr", error);
     }
 
     /* Handle solution */
     if (optstatus != GRB_OPTIMAL) {
-        free_gurobi_resources(env, model, vars_indices);
         return false;
     }
+    return fill_scores(env, kept, board, scores);
+}
+
+
+/* The gurobi backend */
+
+bool gurobi_solve(Board *board) {
+    int row, column, v, dim = board->dim;
+    bool solved;
+    double *scores;
+    Board *solution;
+
+    scores = malloc(dim * dim * dim * sizeof(double));
+    validate_memory_allocation("gurobi_solve", scores);
+    if (!gurobi_solver(board, integer, scores)) {
+        free(scores);
+        return false;
+    }
+
+    /* fill a copy, so the board is left unchanged if the solution is invalid */
+    solution = get_board_copy(board);
+    for (row = 0; row < dim; row++) {
+        for (column = 0; column < dim; column++) {
+            for (v = 0; v < dim; v++) {
+                if (scores[(row * dim + column) * dim + v] == 1.0) {
+                    set_cell_value(solution, row, column, v+1);
+                }
+            }
+        }
+    }
+    free(scores);
+
+    /* Check if the board is solved */
+    solved = !is_board_erroneous(solution) && solution->empty_count == 0;
+    if (solved) {
+        restore_board(board, solution);
+    }
+    destroy_board(solution);
+    return solved;
+}
 
-    success = fill_solution(env, model, board, states, var_type, sol_type, data, threshold,
-            vars_indices, vars_counter);
-    free_gurobi_resources(env, model, vars_indices);
-    return success;
+bool gurobi_get_marginals(const Board *board, double *scores) {
+    return gurobi_solver(board, continuous, scores);
 }
 
+void release_gurobi_resources() {
+    int rows, columns, var_type;
+
+    for (rows = 0; rows <= MAX_DIM; rows++) {
+        for (columns = 0; columns <= MAX_DIM; columns++) {
+            for (var_type = 0; var_type < NUM_OF_VARIABLE_TYPES; var_type++) {
+                if (gurobi_models[rows][columns][var_type] != NULL) {
+                    destroy_gurobi_model(gurobi_models[rows][columns][var_type]);
+                    gurobi_models[rows][columns][var_type] = NULL;
+                }
+            }
+        }
+    }
+    if (gurobi_env != NULL) {
+        GRBfreeenv(gurobi_env);
+        gurobi_env = NULL;
+    }
+}
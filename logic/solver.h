@@ -4,13 +4,29 @@
 
 #include <stdbool.h>
 #include "../components/Board.h"
-#include "../components/StatesList.h"
 
 /** solver:
  *
  * This module is responsible for the logic of the ILP and LP algorithms using
- * Gurobi. It contains multiple configurations of solving, each to be used for
- * a slightly different purpose.
+ * Gurobi, and implements the gurobi solver backend (see backend.h). It's only
+ * built if Gurobi is available (USE_GUROBI is defined).
+ * The Gurobi environment is loaded once, on first use, and the last model of
+ * each board shape (and variable type) is kept with the board it was built
+ * for. The next board of that shape usually differs from it in a few cells
+ * (e.g. after a set or an undo), so rather than being rebuilt, the model is
+ * updated by fixing the variables of the cells that were filled since, and
+ * freeing those of the cells that were cleared since. It's only rebuilt if a
+ * cell that was filled when it was built changed, or a cell was filled with
+ * a value that had no variable.
+ * Nothing is written to files, unless the SUDOKU_GUROBI_DEBUG environment
+ * variable is set: then Gurobi logs to sudoku.log, and every model that's
+ * built is written to sudoku.lp (the variables and constraints are only
+ * named then).
+ * A model is assembled in memory in a single pass, and added to Gurobi with
+ * one call for the variables and one for the constraints. Its variables are
+ * indexed cell by cell (only the empty cells' legal values have entries), so
+ * building it takes time and memory in the number of candidates, rather than
+ * in dim^3.
  */
 
 /* The different types of variables supported:
@@ -22,39 +38,40 @@ typedef enum {
     integer
 } VariableType;
 
-/* The different types of solutions suppported:
- *  - cell_hint will only fill the SolutionData for a single cell
- *  - solve_board will fill the given board with the solution
- *  */
-typedef enum {
-    cell_hint,
-    solve_board
-} SolutionType;
-
-/* SolutionData to be filled in case only a single cell hint is required. */
-typedef struct {
-    int row;
-    int column;
-    double *guesses;
-} SolutionData;
-
 /**
  * The main ILP/LP model solving function. Solves the given board using LP/ILP based
- * on the variable type, and fills the board or the SolutionData based on the given
- * solution type and threshold. In case where a states list is provided, and the
- * solution type supports it, also updates the state list according to the solution.
- * @param board: the board to solve.
- * @param states: a states list to update with the solution. can be NULL.
+ * on the variable type, and fills the scores with the solution: the value of the
+ * variable of each empty cell and legal value, and 0 for the rest (indexed as
+ * the marginals in backend.h).
+ * @param board: the board to solve (left unchanged).
  * @param var_type: the type of variables (determines ILP/LP, see VariableType).
- * @param sol_type: the type of solution (see SolutionType).
- * @param data: the solution data to be filled in case of a cell_hint solution.
- * @param threshold: the threshold to be used in case of running LP solving, with
- * the solve_board option.
- * @return: true if the model solving succeeded, and a solution was updated, and false
- * otherwise.
+ * @param scores: an array of dim^3 scores to fill with the solution.
+ * @return: true if the model solving succeeded, and the scores were filled, and
+ * false otherwise.
+ */
+bool gurobi_solver(const Board *board, VariableType var_type, double *scores);
+
+/**
+ * Solves the board using ILP. The solve operation of the gurobi backend.
+ * @param board: the board to solve. Left unchanged if it can't be solved.
+ * @return: true if the board was solved, and false otherwise.
+ */
+bool gurobi_solve(Board *board);
+
+/**
+ * Fills the scores of the board's empty cells using LP. The get_marginals
+ * operation of the gurobi backend.
+ * @param board: the board to get the scores for.
+ * @param scores: an array of dim^3 scores to fill (see gurobi_solver).
+ * @return: true if the scores were filled, and false otherwise.
+ */
+bool gurobi_get_marginals(const Board *board, double *scores);
+
+/**
+ * Releases the Gurobi environment and the models that were kept (frees all
+ * related memory). To be used once, before the process exits.
  */
-bool gurobi_solver(Board *board, States *states, VariableType var_type, SolutionType sol_type,
-                   SolutionData *data, double threshold);
+void release_gurobi_resources();
 
 
 #endif
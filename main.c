@@ -4,6 +4,8 @@
 #include "GameManager.h"
 #include "io/Printer.h"
 #include "logic/random.h"
+#include "components/Geometry.h"
+#include "logic/backend.h"
 
 /** main:
  *
@@ -22,5 +24,7 @@ int main() {
     }
 
     destroy_game(game);
+    release_geometries();
+    release_backends();
     return 0;
 }
\ No newline at end of file